@@ -0,0 +1,98 @@
+/**
+ * @file bench.c
+ * @author DFlubacher
+ * @brief On-target benchmarks.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "bench.h"
+
+#include <stdint.h>
+
+#include "comms.h"
+#include "printf-stdarg.h"
+#include "profile.h"
+#include "stm32f3xx.h"
+
+#define BENCH_SPI_MAX_LENGTH 64
+
+typedef uint8_t (*BenchSpiMethod)(const uint8_t* tx, uint8_t* rx,
+                                  uint16_t length);
+
+// Clock settings 24, 12, 6 and 3 MHz, chip select on the (idle) BMP390 pin.
+static const BspSpiDevice bench_devices[] = {
+    {24000000, BSP_SPI_MODE_0, 8, GPIOB, 6},
+    {12000000, BSP_SPI_MODE_0, 8, GPIOB, 6},
+    {6000000, BSP_SPI_MODE_0, 8, GPIOB, 6},
+    {3000000, BSP_SPI_MODE_0, 8, GPIOB, 6},
+};
+
+static const uint16_t bench_lengths[] = {4, 16, 64};
+
+static uint8_t bench_tx[BENCH_SPI_MAX_LENGTH];
+static uint8_t bench_rx[BENCH_SPI_MAX_LENGTH];
+
+/**
+ * @brief Byte by byte: write, wait RXNE, read (the former polled path).
+ */
+static uint8_t BenchSpiBytewise(const uint8_t* tx, uint8_t* rx,
+                                uint16_t length) {
+  uint16_t i;
+
+  for (i = 0; i < length; ++i) rx[i] = BspSPI1_SendReceive(tx[i]);
+  return BSP_SPI_OK;
+}
+
+static const struct {
+  const char* name;
+  BenchSpiMethod run;
+} bench_methods[] = {
+    {"bytewise", BenchSpiBytewise},
+    {"polled", BspSPI1_TransferPolled},
+    {"packed", BspSPI1_TransferPacked},
+    {"dma", BspSPI1_Transfer},
+};
+
+void BenchSpi(void) {
+  uint32_t d;
+  uint32_t l;
+  uint32_t m;
+
+  BspSPI1_Init();
+  BspProfileInit();
+
+  stm32_printf("\r\nSPI1 %-9s %6s %6s %8s %12s\r\n", "method", "SCK/Hz",
+               "bytes", "cycles", "gap/SCK x100");
+
+  for (d = 0; d < sizeof(bench_devices) / sizeof(bench_devices[0]); ++d) {
+    uint32_t divider;
+
+    // Configure for the device, but keep its chip select inactive.
+    BspSPI1_Select(&bench_devices[d]);
+    BspSPI1_Deselect(&bench_devices[d]);
+    divider = 2U << ((SPI1->CR1 & SPI_CR1_BR_Msk) >> SPI_CR1_BR_Pos);
+
+    for (m = 0; m < sizeof(bench_methods) / sizeof(bench_methods[0]); ++m) {
+      for (l = 0; l < sizeof(bench_lengths) / sizeof(bench_lengths[0]); ++l) {
+        uint16_t length = bench_lengths[l];
+        uint32_t ideal = 8U * length * divider;
+        uint32_t start;
+        uint32_t cycles;
+        int32_t gap;
+
+        start = DWT->CYCCNT;
+        (void)bench_methods[m].run(bench_tx, bench_rx, length);
+        cycles = DWT->CYCCNT - start;
+
+        // Idle SCK periods per byte, in hundredths (no float formatting).
+        gap = ((int32_t)cycles - (int32_t)ideal) * 100 /
+              (int32_t)(length * divider);
+        stm32_printf("     %-9s %6d %6d %8d %12d\r\n", bench_methods[m].name,
+                     (int)(SystemCoreClock / divider), length, (int)cycles,
+                     (int)gap);
+      }
+    }
+  }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file bench.h
+ * @author DFlubacher
+ * @brief On-target benchmarks, measured with the DWT cycle counter and
+ * printed to the console.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The benchmarks block and use the peripherals directly, run them before the
+ * scheduler starts.
+ *
+ */
+
+#ifndef APP_INCLUDE_BENCH_H_
+#define APP_INCLUDE_BENCH_H_
+
+/**
+ * @brief SPI1 transfer methods (byte-wise, pipelined polled, packed, DMA) at
+ * several clocks and lengths. Reports the idle time between bytes in SCK
+ * periods: (measured cycles - 8 * length * SCK divider) / length / divider.
+ * No device needs to be connected, chip select stays inactive.
+ */
+void BenchSpi(void);
+
+#endif /* APP_INCLUDE_BENCH_H_ */
@@ -28,7 +28,8 @@
 #include "task.h"
 #include "timers.h"
 
-// #include "bsp_timers.h"
+// #include "bench.h"
+#include "bsp_timers.h"
 // #include "comms.h"
 // #include "dac.h"
 #include "printf-stdarg.h"
@@ -46,6 +47,9 @@ int main(void) {
   // Configure the System Clock.
   SystemClockConfig();
 
+  // Start the microsecond timebase for timestamps.
+  BspTimeInit();
+
   // Initialize LED and user button.
   BspLedInit();
 
@@ -56,6 +60,9 @@ int main(void) {
   stm32_printf("SYSCLK: %d Hz\r\n", SystemCoreClock);
   stm32_printf("------------------------\r\n\n");
 
+  // Blocking benchmarks, before the scheduler starts.
+  // BenchSpi();
+
   // Create FreeRTOS tasks.
   xTaskCreate(vTask1, "Task_1", 256, NULL, 1, NULL);
   xTaskCreate(vTask2, "Task_2", 256, NULL, 2, NULL);
@@ -0,0 +1,315 @@
+/**
+ * @file bmp390.c
+ * @author DFlubacher
+ * @brief BMP390 FIFO streaming driver.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "bmp390.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "bsp_timers.h"
+#include "comms.h"
+#include "queue.h"
+#include "spi_bus.h"
+#include "task.h"
+
+// ===   Registers   ==========================================================
+#define BMP390_REG_CHIP_ID 0x00
+#define BMP390_REG_ERR 0x02
+#define BMP390_REG_FIFO_LENGTH 0x12
+#define BMP390_REG_FIFO_DATA 0x14
+#define BMP390_REG_FIFO_CONFIG_1 0x17
+#define BMP390_REG_FIFO_CONFIG_2 0x18
+#define BMP390_REG_PWR_CTRL 0x1B
+#define BMP390_REG_OSR 0x1C
+#define BMP390_REG_ODR 0x1D
+#define BMP390_REG_CONFIG 0x1F
+#define BMP390_REG_CALIB 0x31
+#define BMP390_REG_CMD 0x7E
+
+#define BMP390_CHIP_ID 0x60
+#define BMP390_CALIB_LENGTH 21
+
+#define BMP390_CMD_FIFO_FLUSH 0xB0
+#define BMP390_CMD_SOFT_RESET 0xB6
+
+// PWR_CTRL: press_en, temp_en, normal mode (0b11).
+#define BMP390_PWR_NORMAL 0x33
+
+// FIFO_CONFIG_1: fifo_mode, fifo_time_en, fifo_press_en, fifo_temp_en.
+#define BMP390_FIFO_ENABLE 0x1D
+// FIFO_CONFIG_2: data_select = filtered.
+#define BMP390_FIFO_FILTERED 0x08
+
+// ERR_REG: fatal_err, cmd_err, conf_err.
+#define BMP390_ERR_MASK 0x07
+
+// ===   FIFO frame headers   =================================================
+#define BMP390_FRAME_PRESS_TEMP 0x94
+#define BMP390_FRAME_TEMP 0x90
+#define BMP390_FRAME_PRESS 0x84
+#define BMP390_FRAME_TIME 0xA0
+#define BMP390_FRAME_EMPTY 0x80
+#define BMP390_FRAME_CONFIG 0x48
+#define BMP390_FRAME_ERROR 0x44
+
+#define BMP390_FIFO_SIZE 512
+
+// Room for the sensor time frame appended after the data.
+#define BMP390_FIFO_BURST (BMP390_FIFO_SIZE + 4)
+
+#define BMP390_TIMEOUT pdMS_TO_TICKS(10)
+
+#define BMP390_POLL_PERIOD_MS 50
+
+/**
+ * @brief Calibration coefficients scaled to floating point (data sheet
+ * section 8.4).
+ */
+typedef struct {
+  float t1, t2, t3;
+  float p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11;
+} Bmp390Calib;
+
+static const BspSpiDevice* bmp390;
+static Bmp390Calib calib;
+static uint32_t period_us;
+static BspBmp390Stats stats;
+
+static uint8_t fifo[BMP390_FIFO_BURST];
+
+static uint8_t Bmp390Read(uint8_t reg, uint8_t* data, uint16_t length) {
+  // READ bit, one dummy byte before the data.
+  uint8_t command[2] = {(uint8_t)(reg | 0x80), 0x00};
+
+  return BspSpiBusRead(bmp390, command, 2, data, length, BMP390_TIMEOUT);
+}
+
+static uint8_t Bmp390Write(uint8_t reg, uint8_t value) {
+  uint8_t command = reg & 0x7F;
+
+  return BspSpiBusWrite(bmp390, &command, 1, &value, 1, BMP390_TIMEOUT);
+}
+
+static uint16_t Bmp390U16(const uint8_t* data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t Bmp390U24(const uint8_t* data) {
+  return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+         ((uint32_t)data[2] << 16);
+}
+
+/**
+ * @brief Scale the raw NVM coefficients, e.g. PAR_T1 = NVM_PAR_T1 / 2^-8.
+ *
+ * @param nvm 21 bytes from NVM_PAR_T1 (0x31).
+ */
+static void Bmp390ParseCalib(const uint8_t* nvm) {
+  // Divisors: 2^-8, 2^30, 2^48 (temperature), 2^20, 2^29, 2^32, 2^37, 2^-3,
+  // 2^6, 2^8, 2^15, 2^48, 2^48, 2^65 (pressure).
+  calib.t1 = (float)Bmp390U16(&nvm[0]) * 256.0f;
+  calib.t2 = (float)Bmp390U16(&nvm[2]) / 1073741824.0f;
+  calib.t3 = (float)(int8_t)nvm[4] / 281474976710656.0f;
+  calib.p1 = ((float)(int16_t)Bmp390U16(&nvm[5]) - 16384.0f) / 1048576.0f;
+  calib.p2 = ((float)(int16_t)Bmp390U16(&nvm[7]) - 16384.0f) / 536870912.0f;
+  calib.p3 = (float)(int8_t)nvm[9] / 4294967296.0f;
+  calib.p4 = (float)(int8_t)nvm[10] / 137438953472.0f;
+  calib.p5 = (float)Bmp390U16(&nvm[11]) * 8.0f;
+  calib.p6 = (float)Bmp390U16(&nvm[13]) / 64.0f;
+  calib.p7 = (float)(int8_t)nvm[15] / 256.0f;
+  calib.p8 = (float)(int8_t)nvm[16] / 32768.0f;
+  calib.p9 = (float)(int16_t)Bmp390U16(&nvm[17]) / 281474976710656.0f;
+  calib.p10 = (float)(int8_t)nvm[19] / 281474976710656.0f;
+  calib.p11 = (float)(int8_t)nvm[20] / 36893488147419103232.0f;
+}
+
+/**
+ * @brief Size of the FIFO frame starting with `header`.
+ *
+ * @param header
+ * @return uint16_t bytes including the header, 0 for an empty or unknown
+ *         frame (end of data).
+ */
+static uint16_t Bmp390FrameLength(uint8_t header) {
+  switch (header) {
+    case BMP390_FRAME_PRESS_TEMP:
+      return 7;
+    case BMP390_FRAME_TEMP:
+    case BMP390_FRAME_PRESS:
+    case BMP390_FRAME_TIME:
+      return 4;
+    case BMP390_FRAME_CONFIG:
+    case BMP390_FRAME_ERROR:
+      return 2;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief Compensated temperature (data sheet section 8.5).
+ *
+ * @param raw
+ * @return float degree Celsius.
+ */
+static float Bmp390Temperature(uint32_t raw) {
+  float d1 = (float)raw - calib.t1;
+  float d2 = d1 * calib.t2;
+
+  return d2 + (d1 * d1) * calib.t3;
+}
+
+/**
+ * @brief Compensated pressure (data sheet section 8.6).
+ *
+ * @param raw
+ * @param t compensated temperature.
+ * @return float Pa.
+ */
+static float Bmp390Pressure(uint32_t raw, float t) {
+  float t2 = t * t;
+  float t3 = t2 * t;
+  float p = (float)raw;
+  float p2 = p * p;
+  float out1;
+  float out2;
+  float out3;
+
+  out1 = calib.p5 + calib.p6 * t + calib.p7 * t2 + calib.p8 * t3;
+  out2 = p * (calib.p1 + calib.p2 * t + calib.p3 * t2 + calib.p4 * t3);
+  out3 = p2 * (calib.p9 + calib.p10 * t) + p2 * p * calib.p11;
+
+  return out1 + out2 + out3;
+}
+
+uint8_t BspBmp390Init(const BspSpiDevice* device) {
+  uint8_t data[BMP390_CALIB_LENGTH];
+
+  bmp390 = device;
+  BspSpiBusRegister(device);
+
+  if (Bmp390Read(BMP390_REG_CHIP_ID, data, 1) != BSP_SPI_OK) {
+    return BSP_BMP390_ERR_BUS;
+  }
+  if (data[0] != BMP390_CHIP_ID) return BSP_BMP390_ERR_CHIP_ID;
+
+  // Soft reset, the sensor needs 2 ms to start up again.
+  if (Bmp390Write(BMP390_REG_CMD, BMP390_CMD_SOFT_RESET) != BSP_SPI_OK) {
+    return BSP_BMP390_ERR_BUS;
+  }
+  vTaskDelay(pdMS_TO_TICKS(5));
+
+  if (Bmp390Read(BMP390_REG_CALIB, data, BMP390_CALIB_LENGTH) != BSP_SPI_OK) {
+    return BSP_BMP390_ERR_BUS;
+  }
+  Bmp390ParseCalib(data);
+
+  return BSP_BMP390_OK;
+}
+
+uint8_t BspBmp390Configure(const BspBmp390Config* config) {
+  uint32_t conversion_us;
+  uint8_t error;
+  uint8_t result;
+
+  // Conversion time (data sheet section 3.9.2) must fit into one period.
+  conversion_us = 234 + (392 + (2020U << config->osr_pressure)) +
+                  (163 + (2020U << config->osr_temperature));
+  period_us = 5000U << config->odr;
+  if (conversion_us > period_us) return BSP_BMP390_ERR_CONFIG;
+
+  // Configure in sleep mode (after reset), power up last.
+  result = Bmp390Write(
+      BMP390_REG_OSR,
+      (uint8_t)(config->osr_pressure | (config->osr_temperature << 3)));
+  result |= Bmp390Write(BMP390_REG_ODR, config->odr);
+  result |= Bmp390Write(BMP390_REG_CONFIG, (uint8_t)(config->iir << 1));
+  result |= Bmp390Write(BMP390_REG_FIFO_CONFIG_1, BMP390_FIFO_ENABLE);
+  result |= Bmp390Write(BMP390_REG_FIFO_CONFIG_2,
+                        (config->iir != BSP_BMP390_IIR_BYPASS)
+                            ? BMP390_FIFO_FILTERED
+                            : 0x00);
+  result |= Bmp390Write(BMP390_REG_CMD, BMP390_CMD_FIFO_FLUSH);
+  result |= Bmp390Write(BMP390_REG_PWR_CTRL, BMP390_PWR_NORMAL);
+  if (result != BSP_SPI_OK) return BSP_BMP390_ERR_BUS;
+
+  if (Bmp390Read(BMP390_REG_ERR, &error, 1) != BSP_SPI_OK) {
+    return BSP_BMP390_ERR_BUS;
+  }
+  if ((error & BMP390_ERR_MASK) != 0) return BSP_BMP390_ERR_CONFIG;
+
+  return BSP_BMP390_OK;
+}
+
+uint8_t BspBmp390Poll(QueueHandle_t queue) {
+  uint8_t length_bytes[2];
+  uint16_t length;
+  uint16_t frames = 0;
+  uint16_t frame_length;
+  uint16_t i;
+  uint64_t now_us;
+  BspBmp390Sample sample;
+
+  ++stats.polls;
+
+  if (Bmp390Read(BMP390_REG_FIFO_LENGTH, length_bytes, 2) != BSP_SPI_OK) {
+    ++stats.errors;
+    return BSP_BMP390_ERR_BUS;
+  }
+  length = (uint16_t)(length_bytes[0] | ((length_bytes[1] & 0x01) << 8));
+  if (length == 0) return BSP_BMP390_OK;
+
+  // One burst for all frames, the sensor time frame follows the data.
+  if (length > BMP390_FIFO_SIZE) length = BMP390_FIFO_SIZE;
+  if (Bmp390Read(BMP390_REG_FIFO_DATA, fifo, length + 4) != BSP_SPI_OK) {
+    ++stats.errors;
+    return BSP_BMP390_ERR_BUS;
+  }
+  now_us = BspTimeNowUs();
+
+  // Count the complete sensor frames first, their timestamps count back from
+  // now in steps of the output data period.
+  for (i = 0; i < length; i += frame_length) {
+    frame_length = Bmp390FrameLength(fifo[i]);
+    if ((frame_length == 0) || ((i + frame_length) > length)) break;
+    if (fifo[i] == BMP390_FRAME_PRESS_TEMP) ++frames;
+  }
+
+  for (i = 0; frames > 0; i += frame_length) {
+    frame_length = Bmp390FrameLength(fifo[i]);
+    // Config change, error, time and single channel frames are skipped.
+    if (fifo[i] != BMP390_FRAME_PRESS_TEMP) continue;
+
+    // Temperature first, then pressure, 24 bit little-endian each.
+    --frames;
+    sample.timestamp_us = now_us - (uint64_t)frames * period_us;
+    sample.temperature = Bmp390Temperature(Bmp390U24(&fifo[i + 1]));
+    sample.pressure =
+        Bmp390Pressure(Bmp390U24(&fifo[i + 4]), sample.temperature);
+    if (xQueueSend(queue, &sample, 0) == pdTRUE) {
+      ++stats.samples;
+    } else {
+      ++stats.dropped;
+    }
+  }
+
+  return BSP_BMP390_OK;
+}
+
+void BspBmp390Task(void* pv_parameters) {
+  QueueHandle_t queue = (QueueHandle_t)pv_parameters;
+  TickType_t wake = xTaskGetTickCount();
+
+  while (1) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(BMP390_POLL_PERIOD_MS));
+    (void)BspBmp390Poll(queue);
+  }
+}
+
+const BspBmp390Stats* BspBmp390GetStats(void) { return &stats; }
@@ -13,9 +13,16 @@
 
 #include <stdint.h>
 
+#include "delay.h"
 #include "stm32f303xe.h"
 #include "stm32f3xx.h"
 
+// Upper 32 bit of the timebase, counted by the TIM2 update interrupt.
+static volatile uint32_t time_wraps;
+
+// Alarm callbacks of the TIM2 compare channels 1 ... 4.
+static BspTimeCallback time_alarms[4];
+
 // ////////////////////////////////////////////////////////////////////////////
 // Timers
 // ----------------------------------------------------------------------------
@@ -50,37 +57,12 @@ void BspTimer6TimeBaseInit(uint16_t prescaler, uint16_t interval) {
 }
 
 void BspTimer6DelayInit(void) {
-  // Enable timer 6 clock. Basically source TIM6 with APB1 clock.
-  RCC->APB1ENR |= RCC_APB1ENR_TIM6EN;
-
-  // Reset TIM6 configuration.
-  TIM6->CR1 = 0x0000;
-  TIM6->CR2 = 0x0000;
-
-  // Set TIM6 prescaler:
-  // Freq: 48 MHz -> /48000 -> 1000 Hz counter frequency.
-  // As register is zero based, but prescaler is 1 per default, you need to
-  // subtract 1.
-  TIM6->PSC = (uint16_t)47999;
-
-  // Set ARR to maximum value.
-  TIM6->ARR = (uint16_t)0xFFFF;
+  // TIM6 stays free for BspTimer6TimeBaseInit, the delay service uses the
+  // cycle counter and the TIM2 timebase.
+  BspDelayInit();
 }
 
-void BspTimer6Delay(uint16_t delay_ms) {
-  // Reset the TIM6 counter.
-  TIM6->EGR = TIM_EGR_UG;
-
-  // Start the TIM6 counter.
-  TIM6->CR1 |= TIM_CR1_CEN;
-
-  // Wait until the TIM6 counter reaches the `delay_ms` value.
-  while (TIM6->CNT < delay_ms)
-    ;
-
-  // Stop the TIM6 counter.
-  TIM6->CR1 &= ~TIM_CR1_CEN;
-}
+void BspTimer6Delay(uint16_t delay_ms) { BspDelayMs(delay_ms); }
 
 void BspTimer3InputCaptureSingleEdgeInit(void) {
   // 1. Configure PB4.
@@ -356,3 +338,116 @@ void BspTimer8PwmInit(uint16_t period_ms) {
   // Enable timer 8.
   TIM8->CR1 |= TIM_CR1_CEN;
 }
+
+// ////////////////////////////////////////////////////////////////////////////
+// Timebase
+// ----------------------------------------------------------------------------
+
+void BspTimeInit(void) {
+  // Enable TIM2 clock. Basically source TIM2 with APB1 clock.
+  RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+
+  // Reset timer 2 configuration (32-bit).
+  TIM2->CR1 = 0x0000;
+  TIM2->CR2 = 0x0000;
+  TIM2->SMCR = 0x0000;
+  TIM2->DIER = 0x0000;
+
+  // Freq: 48 MHz -> /48 -> 1 MHz counter frequency, i.e. 1 us resolution.
+  TIM2->PSC = (uint16_t)47;
+
+  // Count the full 32-bit range.
+  TIM2->ARR = 0xFFFFFFFF;
+
+  // Load the prescaler and clear the update flag this causes.
+  TIM2->EGR = TIM_EGR_UG;
+  TIM2->SR = 0;
+  time_wraps = 0;
+
+  // Overflow (update) interrupt. Above the FreeRTOS syscall priority, the
+  // handler doesn't use the kernel and must not be delayed by critical
+  // sections.
+  TIM2->DIER |= TIM_DIER_UIE;
+  NVIC_SetPriority(TIM2_IRQn, 0);
+  NVIC_EnableIRQ(TIM2_IRQn);
+
+  // Set counter enable bit.
+  TIM2->CR1 |= TIM_CR1_CEN;
+}
+
+uint64_t BspTimeNowUs(void) {
+  uint32_t wraps;
+  uint32_t count;
+  uint32_t pending;
+
+  // Retry if the update interrupt ran in between.
+  do {
+    wraps = time_wraps;
+    count = TIM2->CNT;
+    pending = TIM2->SR & TIM_SR_UIF;
+  } while (wraps != time_wraps);
+
+  // Called with the update interrupt pending (from an interrupt of the same
+  // or higher priority, or with interrupts disabled), the wrap isn't counted
+  // yet. A count in the lower half was read after the wrap.
+  if ((pending != 0) && (count < 0x80000000U)) ++wraps;
+
+  return ((uint64_t)wraps << 32) | count;
+}
+
+uint32_t BspTimeNow32(void) { return TIM2->CNT; }
+
+uint8_t BspTimeAlarmStart(uint8_t channel, uint32_t at,
+                          BspTimeCallback callback) {
+  volatile uint32_t* ccr = &TIM2->CCR1 + (channel - 1);
+  uint32_t flag = TIM_SR_CC1IF << (channel - 1);
+  uint32_t primask = __get_PRIMASK();
+  uint8_t late;
+
+  // The compare interrupt runs at priority 0, only masking all interrupts
+  // keeps it out while the alarm is armed and checked.
+  __disable_irq();
+  time_alarms[channel - 1] = callback;
+  *ccr = at;
+  TIM2->SR = ~flag;
+  TIM2->DIER |= flag;
+
+  // A compare only fires when the counter reaches `at`. If it is past
+  // already without a match, the alarm would wait for the next wrap.
+  late = ((int32_t)(TIM2->CNT - at) >= 0) && ((TIM2->SR & flag) == 0);
+  if (late) TIM2->DIER &= ~flag;
+  __set_PRIMASK(primask);
+
+  return late;
+}
+
+void BspTimeAlarmStop(uint8_t channel) {
+  uint32_t flag = TIM_SR_CC1IF << (channel - 1);
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  TIM2->DIER &= ~flag;
+  TIM2->SR = ~flag;
+  __set_PRIMASK(primask);
+}
+
+void TIM2_IRQHandler(void) {
+  // DIER and SR share the bit positions of update and compare 1 ... 4.
+  uint32_t status = TIM2->SR & TIM2->DIER;
+  uint8_t i;
+
+  if ((status & TIM_SR_UIF) != 0) {
+    TIM2->SR = ~(uint32_t)TIM_SR_UIF;
+    ++time_wraps;
+  }
+
+  // Alarms are one-shot, a callback may start its channel again.
+  for (i = 0; i < 4; ++i) {
+    uint32_t flag = TIM_SR_CC1IF << i;
+    if ((status & flag) != 0) {
+      TIM2->DIER &= ~flag;
+      TIM2->SR = ~flag;
+      if (time_alarms[i] != 0) time_alarms[i]();
+    }
+  }
+}
@@ -0,0 +1,173 @@
+/**
+ * @file capture.c
+ * @author DFlubacher
+ * @brief TIM3 input capture with DMA burst logging.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "capture.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "stm32f3xx.h"
+#include "task.h"
+
+// Halfwords in the circular buffer: CCR1, CCR2 per period.
+#define CAPTURE_SIZE (2 * BSP_CAPTURE_PAIRS)
+
+// DMA burst: 2 transfers starting at CCR1 (word offset in TIM_TypeDef).
+#define CAPTURE_DBA ((uint32_t)(&((TIM_TypeDef*)0)->CCR1) / 4)
+#define CAPTURE_DBL 1
+
+static volatile uint16_t capture_buffer[CAPTURE_SIZE];
+
+// Consumer: next pair and half buffers it has passed.
+static uint16_t capture_read;
+static uint32_t capture_read_halves;
+// Falling edge of the last pair decoded, 0 if none yet.
+static uint16_t capture_last_fall;
+static uint8_t capture_primed;
+
+static volatile uint32_t capture_halves;
+static BspCaptureStats capture_stats;
+static TaskHandle_t capture_task;
+
+void BspCaptureInit(void) {
+  // 1. Configure PB4.
+  // Enable port B.
+  RCC->AHBENR |= RCC_AHBENR_GPIOBEN | RCC_AHBENR_DMA1EN;
+
+  // Set PB4 to mode 'Alternate Function' (0b10), AF2 (TIM3_CH1).
+  GPIOB->MODER &= ~GPIO_MODER_MODER4_Msk;
+  GPIOB->MODER |= (0x02 << GPIO_MODER_MODER4_Pos);
+  GPIOB->AFR[0] &= ~GPIO_AFRL_AFRL4_Msk;
+  GPIOB->AFR[0] |= (0x02 << GPIO_AFRL_AFRL4_Pos);
+
+  // 2. Configure Timer 3, 48 MHz, free-running.
+  RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+  TIM3->CR1 = 0x0000;
+  TIM3->CR2 = 0x0000;
+  TIM3->SMCR = 0x0000;
+  TIM3->DIER = 0x0000;
+  TIM3->CCER = 0x0000;
+  TIM3->PSC = 0;
+  TIM3->ARR = 0xFFFF;
+
+  // CC1: input on TI1, CC2: input on TI1 (demux of the pin). Filter: 8
+  // samples at 48 MHz (167 ns), the same delay on both edges.
+  TIM3->CCMR1 = (0x01 << TIM_CCMR1_CC1S_Pos) | (0x02 << TIM_CCMR1_CC2S_Pos) |
+                (0x03 << TIM_CCMR1_IC1F_Pos) | (0x03 << TIM_CCMR1_IC2F_Pos);
+  TIM3->CCMR2 = 0x0000;
+
+  // CC1 falling edge, CC2 rising edge.
+  TIM3->CCER = TIM_CCER_CC1P | TIM_CCER_CC1E | TIM_CCER_CC2E;
+
+  // Each CC1 DMA request reads CCR1 and CCR2 through DMAR.
+  TIM3->DCR =
+      (CAPTURE_DBL << TIM_DCR_DBL_Pos) | (CAPTURE_DBA << TIM_DCR_DBA_Pos);
+  TIM3->DIER = TIM_DIER_CC1DE;
+
+  // 3. DMA1 channel 6 (TIM3_CH1): peripheral to memory, 16 bit, circular,
+  // half and full transfer interrupts.
+  DMA1_Channel6->CCR = 0;
+  DMA1_Channel6->CPAR = (uint32_t)&TIM3->DMAR;
+  DMA1_Channel6->CMAR = (uint32_t)capture_buffer;
+  DMA1_Channel6->CNDTR = CAPTURE_SIZE;
+  DMA1->IFCR = DMA_IFCR_CGIF6;
+  DMA1_Channel6->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PSIZE_0 |
+                       DMA_CCR_MSIZE_0 | DMA_CCR_PL_1 | DMA_CCR_HTIE |
+                       DMA_CCR_TCIE;
+
+  capture_read = 0;
+  capture_read_halves = 0;
+  capture_halves = 0;
+  capture_primed = 0;
+  capture_stats = (BspCaptureStats){0};
+
+  // The handler notifies the consumer task.
+  NVIC_SetPriority(DMA1_Channel6_IRQn, 6);
+  NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
+  DMA1_Channel6->CCR |= DMA_CCR_EN;
+  TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+void BspCaptureStop(void) {
+  TIM3->CR1 &= ~TIM_CR1_CEN;
+  TIM3->DIER = 0x0000;
+  DMA1_Channel6->CCR &= ~DMA_CCR_EN;
+  NVIC_DisableIRQ(DMA1_Channel6_IRQn);
+}
+
+uint16_t BspCaptureRead(BspCapturePulse* pulses, uint16_t max) {
+  uint16_t write;
+  uint16_t n = 0;
+  uint16_t fall;
+  uint16_t rise;
+
+  // Whole pairs only, a burst may be half done.
+  write = (uint16_t)((CAPTURE_SIZE - DMA1_Channel6->CNDTR) & ~1U);
+  if (write == CAPTURE_SIZE) write = 0;
+
+  // More than a half buffer behind: the DMA may be overwriting the data
+  // ahead. Start over at the write position.
+  // The interrupt may lag behind the reader, hence signed.
+  if ((int32_t)(capture_halves - capture_read_halves) >= 2) {
+    ++capture_stats.overruns;
+    capture_read = write;
+    capture_read_halves = capture_halves;
+    capture_primed = 0;
+  }
+
+  while ((capture_read != write) && (n < max)) {
+    fall = capture_buffer[capture_read];
+    rise = capture_buffer[capture_read + 1];
+    capture_read += 2;
+    if ((capture_read % (CAPTURE_SIZE / 2)) == 0) ++capture_read_halves;
+    if (capture_read == CAPTURE_SIZE) capture_read = 0;
+
+    // The first pair only gives the reference edge.
+    if (capture_primed) {
+      pulses[n].period = (uint16_t)(fall - capture_last_fall);
+      pulses[n].width = (uint16_t)(fall - rise);
+      ++n;
+    }
+    capture_last_fall = fall;
+    capture_primed = 1;
+  }
+
+  capture_stats.pulses += n;
+  return n;
+}
+
+uint16_t BspCaptureWait(BspCapturePulse* pulses, uint16_t max,
+                        TickType_t timeout) {
+  capture_task = xTaskGetCurrentTaskHandle();
+  (void)ulTaskNotifyTake(pdTRUE, timeout);
+  return BspCaptureRead(pulses, max);
+}
+
+void BspCaptureGetStats(BspCaptureStats* stats) {
+  *stats = capture_stats;
+  stats->halves = capture_halves;
+}
+
+void DMA1_Channel6_IRQHandler(void) {
+  BaseType_t woken = pdFALSE;
+
+  uint32_t status = DMA1->ISR;
+
+  if ((status & (DMA_ISR_HTIF6 | DMA_ISR_TCIF6)) != 0) {
+    DMA1->IFCR = DMA_IFCR_CHTIF6 | DMA_IFCR_CTCIF6;
+    // Both flags if the interrupt was delayed by more than half a buffer.
+    if ((status & DMA_ISR_HTIF6) != 0) ++capture_halves;
+    if ((status & DMA_ISR_TCIF6) != 0) ++capture_halves;
+    if (capture_task != NULL) vTaskNotifyGiveFromISR(capture_task, &woken);
+  }
+  DMA1->IFCR = DMA_IFCR_CGIF6;
+
+  portYIELD_FROM_ISR(woken);
+}
@@ -14,6 +14,192 @@
 #include "stm32f303xe.h"
 #include "stm32f3xx.h"
 
+// Polling iterations before a flag wait is considered failed.
+#define I2C1_TIMEOUT 100000
+
+// Register map served in target mode.
+static BspRegMap* i2c1_target_map;
+
+// Polling iterations of the SPI1 flag waits. Waits for a whole transfer add
+// its duration (`SPI1_TransferTimeout()`).
+#define SPI1_TIMEOUT 1000000
+
+// Completion of the running SPI1 DMA transfer.
+static volatile uint8_t spi1_busy;
+static volatile uint8_t spi1_status;
+static BspSpiCallback spi1_callback;
+static void* spi1_context;
+
+// Source of the dummy bytes (RX-only) and sink of discarded bytes (TX-only).
+// The memory address is not incremented in these cases.
+// 16 bit wide for frames above 8 bits.
+static const uint16_t spi1_dummy = 0xFFFF;
+static uint16_t spi1_sink;
+
+// Device SPI1 is currently configured for, NULL after `BspSPI1_Init()`.
+static const BspSpiDevice* spi1_device;
+
+// Device selected last, CRC errors are counted for it.
+static const BspSpiDevice* spi1_selected;
+
+// BMP390 on the default chip select PB6. The sensor supports mode 0 and 3 up
+// to 10 MHz.
+static const BspSpiDevice bmp390_device = {10000000, BSP_SPI_MODE_0, 8, GPIOB,
+                                           6};
+
+/**
+ * @brief Polling iterations to wait for a transfer of `length` bytes at the
+ * configured baud rate. An SCK period lasts 2^(BR + 1) core clocks; a
+ * polling iteration takes more than one, so counting one clock per iteration
+ * bounds the transfer time from above.
+ *
+ * @param length
+ * @return uint32_t
+ */
+static uint32_t SPI1_TransferTimeout(uint16_t length) {
+  uint32_t br = (SPI1->CR1 & SPI_CR1_BR_Msk) >> SPI_CR1_BR_Pos;
+
+  return SPI1_TIMEOUT + (((uint32_t)length * 8U) << (br + 1));
+}
+
+/**
+ * @brief Wait until SPI1 has shifted out everything and is idle.
+ */
+static void SPI1_WaitIdle(void) {
+  uint32_t timeout = SPI1_TIMEOUT;
+
+  while ((SPI1->SR & (SPI_SR_FTLVL_Msk | SPI_SR_BSY)) != 0) {
+    if (timeout-- == 0) return;
+  }
+}
+
+/**
+ * @brief Switch the frame size to 8 or 16 bits without a device change, e.g.
+ * for a 16-bit access to an 8-bit device. The next `BspSPI1_Select()`
+ * restores the device configuration.
+ *
+ * @param bits 8 or 16.
+ */
+static void SPI1_SetFrameSize(uint32_t bits) {
+  uint32_t ds = (bits - 1) << SPI_CR2_DS_Pos;
+
+  if ((SPI1->CR2 & SPI_CR2_DS_Msk) == ds) return;
+
+  SPI1_WaitIdle();
+  SPI1->CR1 &= ~SPI_CR1_SPE;
+  SPI1->CR2 = (SPI1->CR2 & ~(SPI_CR2_DS_Msk | SPI_CR2_FRXTH)) | ds;
+  if (bits <= 8) SPI1->CR2 |= SPI_CR2_FRXTH;
+  SPI1->CR1 |= SPI_CR1_SPE;
+  spi1_device = 0;
+}
+
+/**
+ * @brief Restart the CRC calculation for a new transfer (CRCEN toggled while
+ * SPI1 is disabled). No-op without CRC.
+ */
+static void SPI1_CrcReset(void) {
+  if ((SPI1->CR1 & SPI_CR1_CRCEN) == 0) return;
+
+  SPI1_WaitIdle();
+  SPI1->CR1 &= ~SPI_CR1_SPE;
+  SPI1->CR1 &= ~SPI_CR1_CRCEN;
+  SPI1->CR1 |= SPI_CR1_CRCEN;
+  SPI1->CR1 |= SPI_CR1_SPE;
+}
+
+/**
+ * @brief Polled transfers: the last data frame is in the TX FIFO, the CRC
+ * follows it.
+ */
+static void SPI1_CrcNext(void) {
+  if ((SPI1->CR1 & SPI_CR1_CRCEN) != 0) SPI1->CR1 |= SPI_CR1_CRCNEXT;
+}
+
+/**
+ * @brief End of a transfer with CRC: read the received CRC out of the RX
+ * FIFO (the hardware compares it) and evaluate CRCERR.
+ *
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_CRC (counted for the selected
+ *         device), BSP_SPI_ERR_TIMEOUT.
+ */
+static uint8_t SPI1_CrcCheck(void) {
+  uint32_t timeout = SPI1_TIMEOUT;
+  uint32_t frames = 1;
+  uint32_t i;
+
+  if ((SPI1->CR1 & SPI_CR1_CRCEN) == 0) return BSP_SPI_OK;
+
+  // 8-bit frames with a 16-bit CRC (CRCL) receive two CRC frames.
+  if (((SPI1->CR2 & SPI_CR2_DS_Msk) <= (0x07 << SPI_CR2_DS_Pos)) &&
+      ((SPI1->CR1 & SPI_CR1_CRCL) != 0)) {
+    frames = 2;
+  }
+
+  for (i = 0; i < frames; ++i) {
+    while ((SPI1->SR & SPI_SR_RXNE) != SPI_SR_RXNE) {
+      if (timeout-- == 0) return BSP_SPI_ERR_TIMEOUT;
+    }
+    if ((SPI1->CR2 & SPI_CR2_FRXTH) != 0) {
+      (void)*(__IO uint8_t*)&SPI1->DR;
+    } else {
+      (void)*(__IO uint16_t*)&SPI1->DR;
+    }
+  }
+
+  if ((SPI1->SR & SPI_SR_CRCERR) == 0) return BSP_SPI_OK;
+
+  SPI1->SR &= ~SPI_SR_CRCERR;
+  if ((spi1_selected != 0) && (spi1_selected->crc_errors != 0)) {
+    ++*spi1_selected->crc_errors;
+  }
+  return BSP_SPI_ERR_CRC;
+}
+
+/**
+ * @brief Configure SPI1 for `device`: baud rate, mode and frame size.
+ * SPI1 must be disabled while CR1/CR2 change.
+ *
+ * @param device
+ */
+static void SPI1_Configure(const BspSpiDevice* device) {
+  uint32_t br = 0;
+
+  // Fastest clock not above the device maximum. f_SCK = 48 MHz / 2^(BR + 1),
+  // BR = 0b000 (24 MHz) ... 0b111 (187.5 kHz).
+  while ((br < 7) && ((SystemCoreClock >> (br + 1)) > device->max_clock_hz)) {
+    ++br;
+  }
+
+  SPI1_WaitIdle();
+  SPI1->CR1 &= ~SPI_CR1_SPE;
+
+  // Drop leftovers of the previous device.
+  while ((SPI1->SR & SPI_SR_FRLVL_Msk) != 0) {
+    (void)*(__IO uint8_t*)&SPI1->DR;
+  }
+
+  SPI1->CR1 = (SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI |
+               (br << SPI_CR1_BR_Pos) |
+               ((uint32_t)device->mode & 0x03U) << SPI_CR1_CPHA_Pos);
+
+  // Data size DS = bits - 1. RXNE per frame for frames up to 8 bits.
+  SPI1->CR2 = ((uint32_t)(device->frame_bits - 1) << SPI_CR2_DS_Pos);
+  if (device->frame_bits <= 8) SPI1->CR2 |= SPI_CR2_FRXTH;
+
+  // Hardware CRC, only configurable while SPI1 is disabled. CRCL selects a
+  // 16-bit CRC; frames above 8 bits always use one, whatever crc_bits.
+  if (device->crc_polynomial != 0) {
+    SPI1->CRCPR = device->crc_polynomial;
+    if ((device->crc_bits == 16) || (device->frame_bits > 8)) {
+      SPI1->CR1 |= SPI_CR1_CRCL;
+    }
+    SPI1->CR1 |= SPI_CR1_CRCEN;
+  }
+
+  SPI1->CR1 |= SPI_CR1_SPE;
+  spi1_device = device;
+}
+
 void BspI2C1_Init(void) {
   // Enable GPIOB:
   RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
@@ -59,148 +245,278 @@ void BspI2C1_Init(void) {
   I2C1->CR1 |= I2C_CR1_PE;
 }
 
-uint8_t BspI2C1_Read(uint8_t device_address, uint8_t register_address,
-                     uint8_t* buffer, uint8_t nbytes) {
+/**
+ * @brief Wait until all bits of `flag` are set in I2C1_ISR.
+ *
+ * @param flag
+ * @return uint8_t 0 on success, 1 on NACK or timeout.
+ */
+static uint8_t I2C1_WaitFlag(uint32_t flag) {
   // Flag no response received.
-  uint32_t timeout = 100000;
+  uint32_t timeout = I2C1_TIMEOUT;
+  uint32_t isr;
 
-  // Loop counter.
-  uint8_t n = nbytes;
+  do {
+    isr = I2C1->ISR;
 
-  // Set device address. 7bit aligned left in 8-bit of SADD.
-  I2C1->CR2 &= ~I2C_CR2_SADD_Msk;
-  I2C1->CR2 |= ((device_address << 1U) << I2C_CR2_SADD_Pos);
+    // The receiver did not acknowledge, abort.
+    if ((isr & I2C_ISR_NACKF) == I2C_ISR_NACKF) return 1;
 
-  // Set I2C1 to write mode.
-  I2C1->CR2 &= ~I2C_CR2_RD_WRN;
+    // Check if time is up.
+    if (timeout-- == 0) return 1;
+  } while ((isr & flag) != flag);
 
-  // Configure for transfer of nbytes = 1, with AUTOEND = 0.
-  I2C1->CR2 &= ~I2C_CR2_NBYTES_Msk;
-  I2C1->CR2 |= (0x01 << I2C_CR2_NBYTES_Pos);
-  I2C1->CR2 &= ~I2C_CR2_AUTOEND;
+  return 0;
+}
 
-  // Start transmission. Reset by hardware.
-  I2C1->CR2 |= I2C_CR2_START;
+/**
+ * @brief Release the bus after a failed transfer and return `error`.
+ *
+ * @param error
+ * @return uint8_t
+ */
+static uint8_t I2C1_Abort(uint8_t error) {
+  uint32_t timeout = I2C1_TIMEOUT;
 
-  // ===   REQUEST   ==========================================================
-  // Check if the Transfer Interrupt Status is empty before proceeding.
-  while ((I2C1->ISR & I2C_ISR_TXIS_Msk) != I2C_ISR_TXIS) {
-    // Check if time is up.
-    if (timeout-- == 0) return 1;
+  // After a NACK the STOP condition is generated by hardware, otherwise
+  // request it.
+  if ((I2C1->ISR & I2C_ISR_NACKF) != I2C_ISR_NACKF) {
+    I2C1->CR2 |= I2C_CR2_STOP;
   }
-  timeout = 100000;
-
-  // Send register address.
-  I2C1->TXDR = register_address;
 
-  // Wait until transmission is completed.
-  while ((I2C1->ISR & I2C_ISR_TC_Msk) != I2C_ISR_TC) {
-    // Check if time is up.
-    if (timeout-- == 0) return 2;
+  // Wait for 'Stop detection flag'.
+  while ((I2C1->ISR & I2C_ISR_STOPF_Msk) != I2C_ISR_STOPF) {
+    if (timeout-- == 0) break;
   }
-  timeout = 1000000;
-  // ===   Request completed   ================================================
 
-  // Enter Read mode.
-  I2C1->CR2 |= I2C_CR2_RD_WRN;
+  // Flush the transmit data register and clear the flags.
+  I2C1->ISR |= I2C_ISR_TXE;
+  I2C1->ICR = (I2C_ICR_STOPCF | I2C_ICR_NACKCF);
+
+  return error;
+}
 
-  // Receive nbytes, AUTOEND = 0.
-  I2C1->CR2 &= ~I2C_CR2_NBYTES_Msk;
-  I2C1->CR2 |= (nbytes << I2C_CR2_NBYTES_Pos);
-  I2C1->CR2 &= ~I2C_CR2_AUTOEND;
+uint8_t BspI2C1_Transfer(const BspI2cTransaction* transaction) {
+  const BspI2cSegment* segment = transaction->segments;
+  const BspI2cSegment* end = segment + transaction->nsegments;
+  const BspI2cSegment* run_end;
+  uint8_t* data;
+  uint16_t left;
+  uint32_t remaining;
+  uint32_t chunk;
+  uint32_t cr2;
+  uint32_t timeout;
+  uint8_t read;
+  uint8_t first = 1;
+
+  // Clear flags of a previous transaction.
+  I2C1->ICR = (I2C_ICR_STOPCF | I2C_ICR_NACKCF);
+
+  while (segment < end) {
+    // A bus transfer (one START) covers all following segments with the same
+    // direction and without the RESTART flag.
+    read = segment->flags & BSP_I2C_SEG_READ;
+    remaining = segment->length;
+    run_end = segment + 1;
+    while ((run_end < end) &&
+           ((run_end->flags & BSP_I2C_SEG_READ) == read) &&
+           ((run_end->flags & BSP_I2C_SEG_RESTART) == 0)) {
+      remaining += run_end->length;
+      ++run_end;
+    }
 
-  // Start transmission. Reset by hardware.
-  I2C1->CR2 |= I2C_CR2_START;
+    // NBYTES is limited to 255, longer transfers are reloaded (TCR).
+    chunk = (remaining > 255) ? 255 : remaining;
+
+    // Set device address (7bit aligned left in 8-bit of SADD), direction and
+    // number of bytes, AUTOEND = 0. START is reset by hardware. If the
+    // previous transfer completed (TC), this is a repeated START.
+    cr2 = ((uint32_t)transaction->device_address << 1U) << I2C_CR2_SADD_Pos;
+    cr2 |= (chunk << I2C_CR2_NBYTES_Pos);
+    if (read) cr2 |= I2C_CR2_RD_WRN;
+    if (remaining > chunk) cr2 |= I2C_CR2_RELOAD;
+    I2C1->CR2 = cr2 | I2C_CR2_START;
+
+    data = segment->data;
+    left = segment->length;
+
+    while (remaining > 0) {
+      // Move on to the next non-empty segment of this transfer.
+      while (left == 0) {
+        ++segment;
+        data = segment->data;
+        left = segment->length;
+      }
+
+      if (read) {
+        // Wait for 'Receive data register not empty' flag.
+        if (I2C1_WaitFlag(I2C_ISR_RXNE)) {
+          return I2C1_Abort(first ? BSP_I2C_ERR_ADDRESS : BSP_I2C_ERR_READ);
+        }
+
+        // Store data in place. Reading RXDR clears the RXNE flag.
+        *data = I2C1->RXDR;
+      } else {
+        // Wait for 'Transmit interrupt status' flag.
+        if (I2C1_WaitFlag(I2C_ISR_TXIS)) {
+          return I2C1_Abort(first ? BSP_I2C_ERR_ADDRESS : BSP_I2C_ERR_WRITE);
+        }
+
+        // Send data.
+        I2C1->TXDR = *data;
+      }
+      first = 0;
+      ++data;
+      --left;
+      --remaining;
+      --chunk;
+
+      // Reload the next chunk of at most 255 bytes.
+      if ((chunk == 0) && (remaining > 0)) {
+        if (I2C1_WaitFlag(I2C_ISR_TCR)) {
+          return I2C1_Abort(read ? BSP_I2C_ERR_READ : BSP_I2C_ERR_WRITE);
+        }
+        chunk = (remaining > 255) ? 255 : remaining;
+        cr2 = I2C1->CR2 & ~(I2C_CR2_NBYTES_Msk | I2C_CR2_RELOAD);
+        cr2 |= (chunk << I2C_CR2_NBYTES_Pos);
+        if (remaining > chunk) cr2 |= I2C_CR2_RELOAD;
+        I2C1->CR2 = cr2;
+      }
+    }
 
-  while (n > 0) {
-    // Wait for 'Receive data register not empty' flag.
-    while ((I2C1->ISR & I2C_ISR_RXNE_Msk) != I2C_ISR_RXNE) {
-      // Check if time is up.
-      if (timeout-- == 0) return (240 + n);
+    // Wait until the transfer is completed. A zero-length transfer only
+    // sends the address (device probing).
+    if (I2C1_WaitFlag(I2C_ISR_TC)) {
+      if (first) return I2C1_Abort(BSP_I2C_ERR_ADDRESS);
+      return I2C1_Abort(read ? BSP_I2C_ERR_READ : BSP_I2C_ERR_WRITE);
     }
-    timeout = 100000;
 
-    // Store data in buffer. Reading RXDR clears the RXNE flag.
-    *buffer = I2C1->RXDR;
-    ++buffer;
-    --n;
+    segment = run_end;
   }
 
-  // ===   Reception completed   ==============================================
+  // ===   Transaction completed   ============================================
 
   // Generate STOP condition.
   I2C1->CR2 |= I2C_CR2_STOP;
 
   // Wait for 'Stop detection flag'.
+  timeout = I2C1_TIMEOUT;
   while ((I2C1->ISR & I2C_ISR_STOPF_Msk) != I2C_ISR_STOPF) {
     // Check if time is up.
-    if (timeout-- == 0) return 4;
+    if (timeout-- == 0) return BSP_I2C_ERR_STOP;
   }
 
+  // Clear STOPF flag.
+  I2C1->ICR = I2C_ICR_STOPCF;
+
   // Return success.
-  return 0;
+  return BSP_I2C_OK;
+}
+
+uint8_t BspI2C1_Read(uint8_t device_address, uint8_t register_address,
+                     uint8_t* buffer, uint8_t nbytes) {
+  // Request the register, then receive after a repeated START.
+  BspI2cSegment segments[2] = {
+      {&register_address, 1, BSP_I2C_SEG_WRITE},
+      {buffer, nbytes, BSP_I2C_SEG_READ | BSP_I2C_SEG_RESTART},
+  };
+  BspI2cTransaction transaction = {device_address, segments, 2};
+
+  return BspI2C1_Transfer(&transaction);
 }
 
 uint8_t BspI2C1_Write(uint8_t device_address, uint8_t register_address,
                       uint8_t* buffer, uint8_t nbytes) {
-  // Flag no response received.
-  uint32_t timeout = 100000;
+  // Register address and payload are sent in the same transfer.
+  BspI2cSegment segments[2] = {
+      {&register_address, 1, BSP_I2C_SEG_WRITE},
+      {buffer, nbytes, BSP_I2C_SEG_WRITE},
+  };
+  BspI2cTransaction transaction = {device_address, segments, 2};
+
+  return BspI2C1_Transfer(&transaction);
+}
 
-  // Loop counter.
-  uint8_t n = nbytes;
+void BspI2C1_TargetInit(uint8_t own_address, BspRegMap* map) {
+  i2c1_target_map = map;
 
-  // Set device address. 7bit aligned left in 8-bit of SADD.
-  I2C1->CR2 &= ~I2C_CR2_SADD_Msk;
-  I2C1->CR2 |= ((device_address << 1U) << I2C_CR2_SADD_Pos);
+  // Pins, clock and timing (SDADEL/SCLDEL are used in target mode as well).
+  BspI2C1_Init();
 
-  // Set I2C1 to write mode.
-  I2C1->CR2 &= ~I2C_CR2_RD_WRN;
+  // NOSTRETCH can only be changed while I2C1 is disabled.
+  I2C1->CR1 &= ~I2C_CR1_PE;
 
-  // Configure for transfer of nbytes + address, with AUTOEND = 0.
-  I2C1->CR2 &= ~I2C_CR2_NBYTES_Msk;
-  I2C1->CR2 |= ((nbytes + 1) << I2C_CR2_NBYTES_Pos);
-  I2C1->CR2 |= I2C_CR2_AUTOEND;
+  // Own address 1, 7-bit, aligned left (OA1[7:1]).
+  I2C1->OAR1 = 0x00000000;
+  I2C1->OAR1 = ((uint32_t)own_address << 1U) << I2C_OAR1_OA1_Pos;
+  I2C1->OAR1 |= I2C_OAR1_OA1EN;
 
-  // Clear STOPF flag.
-  I2C1->ICR &= ~I2C_ICR_STOPCF_Msk;
+  // Never stretch the clock, the host always gets data immediately.
+  // Enable address match, receive, transmit, NACK, STOP and error interrupts.
+  I2C1->CR1 |= (I2C_CR1_NOSTRETCH | I2C_CR1_ADDRIE | I2C_CR1_RXIE |
+                I2C_CR1_TXIE | I2C_CR1_NACKIE | I2C_CR1_STOPIE |
+                I2C_CR1_ERRIE);
 
-  // Start transmission. Reset by hardware.
-  I2C1->CR2 |= I2C_CR2_START;
+  // Enable I2C1.
+  I2C1->CR1 |= I2C_CR1_PE;
 
-  // Check if the Transfer Interrupt Status is empty before proceeding.
-  while ((I2C1->ISR & I2C_ISR_TXIS_Msk) != I2C_ISR_TXIS) {
-    // Check if time is up.
-    if (timeout-- == 0) return 1;
-  }
-  timeout = 100000;
+  // Without clock stretching, the first byte must be in TXDR before the host
+  // addresses us.
+  I2C1->TXDR = BspRegMapHostReadFirst(map);
 
-  // Send register address.
-  I2C1->TXDR = register_address;
+  // Priority below configMAX_SYSCALL_INTERRUPT_PRIORITY, so the write
+  // callback may use FreeRTOS ...FromISR() functions.
+  NVIC_SetPriority(I2C1_EV_IRQn, 6);
+  NVIC_SetPriority(I2C1_ER_IRQn, 6);
+  NVIC_EnableIRQ(I2C1_EV_IRQn);
+  NVIC_EnableIRQ(I2C1_ER_IRQn);
+}
 
-  while (n > 0) {
-    // Wait for 'Receive data register not empty' flag.
-    while ((I2C1->ISR & I2C_ISR_TXIS_Msk) != I2C_ISR_TXIS) {
-      // Check if time is up.
-      if (timeout-- == 0) return 2;
-    }
-    timeout = 100000;
+/**
+ * @brief I2C1 event interrupt (target mode).
+ */
+void I2C1_EV_IRQHandler(void) {
+  uint32_t isr = I2C1->ISR;
 
-    // Send data.
-    I2C1->TXDR = *buffer;
-    ++buffer;
-    --n;
+  // Address matched. DIR = 1: the host reads.
+  if ((isr & I2C_ISR_ADDR) == I2C_ISR_ADDR) {
+    BspRegMapHostStart(i2c1_target_map, (isr & I2C_ISR_DIR) == I2C_ISR_DIR);
+    I2C1->ICR = I2C_ICR_ADDRCF;
   }
 
-  // ===   Transmission completed ==============================================
+  // Byte from the host. The pointer may have moved, replace the preloaded
+  // byte (writing TXE flushes TXDR).
+  if ((isr & I2C_ISR_RXNE) == I2C_ISR_RXNE) {
+    BspRegMapHostWrite(i2c1_target_map, (uint8_t)I2C1->RXDR);
+    I2C1->ISR |= I2C_ISR_TXE;
+    I2C1->TXDR = BspRegMapHostReadFirst(i2c1_target_map);
+  }
 
-  // Wait for 'Stop detection flag'.
-  while ((I2C1->ISR & I2C_ISR_STOPF_Msk) != I2C_ISR_STOPF) {
-    // Check if time is up.
-    if (timeout-- == 0) return 3;
+  // The preloaded byte moved to the shift register, preload the next one.
+  if ((isr & I2C_ISR_TXIS) == I2C_ISR_TXIS) {
+    I2C1->TXDR = BspRegMapHostReadNext(i2c1_target_map);
   }
 
-  // Return success.
-  return 0;
+  // The host does not want more data.
+  if ((isr & I2C_ISR_NACKF) == I2C_ISR_NACKF) {
+    I2C1->ICR = I2C_ICR_NACKCF;
+  }
+
+  // End of transaction: latch a committed frame and preload its first byte.
+  if ((isr & I2C_ISR_STOPF) == I2C_ISR_STOPF) {
+    BspRegMapHostStop(i2c1_target_map);
+    I2C1->ICR = I2C_ICR_STOPCF;
+    I2C1->ISR |= I2C_ISR_TXE;
+    I2C1->TXDR = BspRegMapHostReadFirst(i2c1_target_map);
+  }
+}
+
+/**
+ * @brief I2C1 error interrupt (target mode). Bus error, arbitration loss and
+ * over-/underrun only need to be acknowledged, the next STOP resynchronizes.
+ */
+void I2C1_ER_IRQHandler(void) {
+  I2C1->ICR = (I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF);
 }
 
 void BspSPI1_Init(void) {
@@ -274,10 +590,179 @@ void BspSPI1_Init(void) {
   // configured as input (SPI_CR1).
   SPI1->CR1 |= (SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI);
 
+  // RXNE (and the RX DMA request) per byte.
+  SPI1->CR2 |= SPI_CR2_FRXTH;
+
+  // ===   Configure DMA1 channel 2 (SPI1_RX) and 3 (SPI1_TX)   ===============
+  RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+  DMA1_Channel2->CCR = 0x00000000;
+  DMA1_Channel3->CCR = 0x00000000;
+  DMA1_Channel2->CPAR = (uint32_t)&SPI1->DR;
+  DMA1_Channel3->CPAR = (uint32_t)&SPI1->DR;
+
+  // The transfer completes with the last received byte, only the RX channel
+  // interrupts. Priority below configMAX_SYSCALL_INTERRUPT_PRIORITY, so the
+  // completion callback may use FreeRTOS ...FromISR() functions.
+  NVIC_SetPriority(DMA1_Channel2_IRQn, 6);
+  NVIC_EnableIRQ(DMA1_Channel2_IRQn);
+
+  spi1_busy = 0;
+  spi1_device = 0;
+
   // Enable SPI1.
   SPI1->CR1 |= SPI_CR1_SPE;
 }
 
+void BspSPI1_DeviceInit(const BspSpiDevice* device) {
+  GPIO_TypeDef* port = device->cs_port;
+  uint32_t pin = device->cs_pin;
+
+  // GPIOA ... GPIOF are 1 KiB apart, their clock enable bits are adjacent.
+  RCC->AHBENR |= (RCC_AHBENR_GPIOAEN
+                  << (((uint32_t)port - GPIOA_BASE) >> 10));
+
+  // Deselected (high) before the pin becomes an output.
+  port->BSRR = (1U << pin);
+
+  // Push-pull, high-speed output, no pull-up/pull-down.
+  port->MODER &= ~(0x03U << (2 * pin));
+  port->MODER |= (0x01U << (2 * pin));
+  port->OTYPER &= ~(1U << pin);
+  port->PUPDR &= ~(0x03U << (2 * pin));
+  port->OSPEEDR |= (0x03U << (2 * pin));
+}
+
+void BspSPI1_Select(const BspSpiDevice* device) {
+  if (device != spi1_device) SPI1_Configure(device);
+  spi1_selected = device;
+
+  device->cs_port->BSRR = (1U << (device->cs_pin + 16));
+}
+
+void BspSPI1_Deselect(const BspSpiDevice* device) {
+  // CS must not rise before the last frame has left the shift register.
+  SPI1_WaitIdle();
+
+  device->cs_port->BSRR = (1U << device->cs_pin);
+}
+
+uint8_t BspSPI1_TransferStart(const uint8_t* tx, uint8_t* rx, uint16_t length,
+                              BspSpiCallback callback, void* context) {
+  uint32_t size = 0;
+
+  if (spi1_busy) return BSP_SPI_ERR_BUSY;
+
+  if (length == 0) {
+    if (callback != 0) callback(BSP_SPI_OK, context);
+    return BSP_SPI_OK;
+  }
+
+  spi1_busy = 1;
+  spi1_status = BSP_SPI_OK;
+  spi1_callback = callback;
+  spi1_context = context;
+
+  // Drop stale bytes of earlier polled accesses, they would shift the
+  // received data by one.
+  while ((SPI1->SR & SPI_SR_FRLVL_Msk) != 0) {
+    (void)*(__IO uint8_t*)&SPI1->DR;
+  }
+  (void)SPI1->SR;
+
+  // With CRC enabled, the TX DMA end makes the hardware send the CRC, no
+  // CRCNEXT needed. The received CRC is checked in the interrupt.
+  SPI1_CrcReset();
+
+  // Frames above 8 bits move as half-words.
+  if ((SPI1->CR2 & SPI_CR2_DS_Msk) > (0x07 << SPI_CR2_DS_Pos)) {
+    size = (DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0);
+  }
+
+  // ===   RX channel: peripheral to memory   =================================
+  DMA1->IFCR = DMA_IFCR_CGIF2;
+  DMA1_Channel2->CCR = (DMA_CCR_PL_1 | DMA_CCR_TCIE | DMA_CCR_TEIE | size);
+  if (rx != 0) {
+    DMA1_Channel2->CMAR = (uint32_t)rx;
+    DMA1_Channel2->CCR |= DMA_CCR_MINC;
+  } else {
+    DMA1_Channel2->CMAR = (uint32_t)&spi1_sink;
+  }
+  DMA1_Channel2->CNDTR = length;
+
+  // ===   TX channel: memory to peripheral   =================================
+  DMA1->IFCR = DMA_IFCR_CGIF3;
+  DMA1_Channel3->CCR = (DMA_CCR_DIR | size);
+  if (tx != 0) {
+    DMA1_Channel3->CMAR = (uint32_t)tx;
+    DMA1_Channel3->CCR |= DMA_CCR_MINC;
+  } else {
+    DMA1_Channel3->CMAR = (uint32_t)&spi1_dummy;
+  }
+  DMA1_Channel3->CNDTR = length;
+
+  // Sequence from RM0316 (SPI communication using DMA): RX request first,
+  // then the channels, the TX request starts the transfer.
+  SPI1->CR2 |= SPI_CR2_RXDMAEN;
+  DMA1_Channel2->CCR |= DMA_CCR_EN;
+  DMA1_Channel3->CCR |= DMA_CCR_EN;
+  SPI1->CR2 |= SPI_CR2_TXDMAEN;
+
+  return BSP_SPI_OK;
+}
+
+uint8_t BspSPI1_Transfer(const uint8_t* tx, uint8_t* rx, uint16_t length) {
+  uint32_t timeout;
+  uint8_t result;
+
+  result = BspSPI1_TransferStart(tx, rx, length, 0, 0);
+  if (result != BSP_SPI_OK) return result;
+
+  timeout = SPI1_TransferTimeout(length);
+  while (spi1_busy) {
+    if (timeout-- == 0) {
+      BspSPI1_TransferAbort();
+      return BSP_SPI_ERR_TIMEOUT;
+    }
+  }
+
+  return spi1_status;
+}
+
+uint8_t BspSPI1_TransferBusy(void) { return spi1_busy; }
+
+void BspSPI1_TransferAbort(void) {
+  // Disabling the channels cancels the remaining requests, a disabled channel
+  // does not interrupt any more.
+  DMA1_Channel2->CCR &= ~DMA_CCR_EN;
+  DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+  DMA1->IFCR = (DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3);
+  SPI1->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+  spi1_busy = 0;
+}
+
+/**
+ * @brief SPI1 RX DMA interrupt: end of a `BspSPI1_TransferStart()` transfer.
+ * The last byte has been received, so the transmitter is idle as well.
+ */
+void DMA1_Channel2_IRQHandler(void) {
+  uint32_t isr = DMA1->ISR;
+  BspSpiCallback callback = spi1_callback;
+
+  DMA1->IFCR = (DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3);
+  if ((isr & DMA_ISR_TEIF2) == DMA_ISR_TEIF2) spi1_status = BSP_SPI_ERR_DMA;
+
+  DMA1_Channel2->CCR &= ~DMA_CCR_EN;
+  DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+  SPI1->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+
+  // The CRC follows the last data frame, at most 16 SCK periods.
+  if (spi1_status == BSP_SPI_OK) spi1_status = SPI1_CrcCheck();
+
+  spi1_busy = 0;
+  if (callback != 0) callback(spi1_status, spi1_context);
+}
+
 uint8_t BspSPI1_SendReceive(uint8_t tx_byte) {
   // uint16_t BspSPI1_SendReceive(uint16_t tx_byte) {
   // Flag no response received.
@@ -309,80 +794,143 @@ uint8_t BspSPI1_SendReceive(uint8_t tx_byte) {
 }
 
 uint16_t BspSPI1_SendReceive16(uint16_t tx_byte) {
-  // Flag no response received.
-  uint32_t timeout = 100000;
-  uint16_t rx_byte;
+  uint16_t rx_byte = 0;
 
-  // Make sure the TXE flag is set before writing to the data register.
-  // SR: status register.
-  while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE) {
-    if (timeout-- == 0) return 1;
-  }
-  timeout = 100000;
+  // A real 16-bit frame, not two packed 8-bit frames.
+  SPI1_SetFrameSize(16);
+  (void)BspSPI1_Transfer16(&tx_byte, &rx_byte, 1);
 
-  // Transmit the byte.
-  // *(__IO uint8_t*)&SPI1->DR = tx_byte;
-  SPI1->DR = tx_byte;
+  return rx_byte;
+}
 
-  // Wait until incoming data has arrived.
-  while ((SPI1->SR & SPI_SR_RXNE_Msk) != SPI_SR_RXNE) {
-    if (timeout-- == 0) return 2;
+uint8_t BspSPI1_Transfer16(const uint16_t* tx, uint16_t* rx, uint16_t count) {
+  uint32_t timeout = SPI1_TIMEOUT;
+  uint16_t sent = 0;
+  uint16_t received = 0;
+  uint16_t value;
+
+  SPI1_SetFrameSize(16);
+  SPI1_CrcReset();
+
+  // Keep at most two frames in flight, the RX FIFO holds two 16-bit frames.
+  while (received < count) {
+    if ((sent < count) && ((sent - received) < 2) &&
+        ((SPI1->SR & SPI_SR_TXE) == SPI_SR_TXE)) {
+      *(__IO uint16_t*)&SPI1->DR = (tx != 0) ? tx[sent] : spi1_dummy;
+      if (++sent == count) SPI1_CrcNext();
+    }
+    if ((SPI1->SR & SPI_SR_RXNE) == SPI_SR_RXNE) {
+      value = *(__IO uint16_t*)&SPI1->DR;
+      if (rx != 0) rx[received] = value;
+      ++received;
+      timeout = SPI1_TIMEOUT;
+    } else if (timeout-- == 0) {
+      return BSP_SPI_ERR_TIMEOUT;
+    }
   }
 
-  // Read data sent by slave.
-  // rx_byte = *(__IO uint8_t*)&SPI1->DR;
-  rx_byte = SPI1->DR;
-
-  return rx_byte;
+  return SPI1_CrcCheck();
 }
 
-uint8_t BspSPI1_BMP390_Read(uint8_t register_address, uint8_t length,
-                            uint8_t* response) {
-  uint32_t timeout = 100000;
-  uint8_t n = length;
-  // Set FIFO reception threshold to 1.
-  // 1: RXNE event is generated if the FIFO level is greater than or equal to
-  // 1/4 (8-bit).
-  SPI1->CR2 |= SPI_CR2_FRXTH;
+uint8_t BspSPI1_TransferPolled(const uint8_t* tx, uint8_t* rx,
+                               uint16_t length) {
+  uint32_t timeout = SPI1_TIMEOUT;
+  uint16_t sent = 0;
+  uint16_t received = 0;
+  uint8_t value;
+
+  SPI1_SetFrameSize(8);
+  SPI1_CrcReset();
+
+  while (received < length) {
+    // Top up the TX FIFO (FTLVL below full). At most four bytes in flight, so
+    // the 4-byte RX FIFO cannot overrun while we are busy writing.
+    while ((sent < length) && ((uint16_t)(sent - received) < 4) &&
+           ((SPI1->SR & SPI_SR_FTLVL_Msk) != SPI_SR_FTLVL_Msk)) {
+      *(__IO uint8_t*)&SPI1->DR = (tx != 0) ? tx[sent] : 0xFF;
+      if (++sent == length) SPI1_CrcNext();
+    }
 
-  // Select the slave (CS --> low).
-  GPIOB->BSRR = GPIO_BSRR_BR_6;
+    // Drain whatever has arrived (FRLVL not empty).
+    while ((SPI1->SR & SPI_SR_FRLVL_Msk) != 0) {
+      value = *(__IO uint8_t*)&SPI1->DR;
+      if (rx != 0) rx[received] = value;
+      ++received;
+      timeout = SPI1_TIMEOUT;
+    }
 
-  // Make sure the TXE flag is set before writing to the data register.
-  // SR: status register.
-  while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE) {
-    if (timeout-- == 0) return 1;
+    if (timeout-- == 0) return BSP_SPI_ERR_TIMEOUT;
   }
-  timeout = 1000000;
 
-  // Transmit the byte, add the READ bit.
-  *(__IO uint8_t*)&SPI1->DR = (register_address | 0x80);
-  // SPI1->DR = tx_byte;
-  while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE) {
-    if (timeout-- == 0) return 1;
-  }
-  timeout = 1000000;
+  return SPI1_CrcCheck();
+}
 
-  // // Transmit dummy byte.
-  *(__IO uint8_t*)&SPI1->DR = 0x42;
-  while ((SPI1->SR & SPI_SR_TXE_Msk) != SPI_SR_TXE) {
-    if (timeout-- == 0) return 1;
+uint8_t BspSPI1_TransferPacked(const uint8_t* tx, uint8_t* rx,
+                               uint16_t length) {
+  uint32_t timeout = SPI1_TIMEOUT;
+  uint16_t pairs = length / 2;
+  uint16_t sent = 0;
+  uint16_t received = 0;
+  uint16_t value;
+
+  SPI1_SetFrameSize(8);
+  SPI1_CrcReset();
+
+  // Data packing: a half-word access to DR moves two 8-bit frames, the first
+  // frame in the low byte. RXNE at FIFO level >= 1/2 (two frames).
+  SPI1->CR2 &= ~SPI_CR2_FRXTH;
+
+  // At most two pairs in flight, the RX FIFO holds four bytes.
+  while (received < pairs) {
+    if ((sent < pairs) && ((sent - received) < 2) &&
+        ((SPI1->SR & SPI_SR_TXE) == SPI_SR_TXE)) {
+      value = (tx != 0) ? (uint16_t)(tx[2 * sent] | (tx[2 * sent + 1] << 8))
+                        : spi1_dummy;
+      *(__IO uint16_t*)&SPI1->DR = value;
+      if ((++sent == pairs) && ((length & 1U) == 0)) SPI1_CrcNext();
+    }
+    if ((SPI1->SR & SPI_SR_RXNE) == SPI_SR_RXNE) {
+      value = *(__IO uint16_t*)&SPI1->DR;
+      if (rx != 0) {
+        rx[2 * received] = (uint8_t)value;
+        rx[2 * received + 1] = (uint8_t)(value >> 8);
+      }
+      ++received;
+      timeout = SPI1_TIMEOUT;
+    } else if (timeout-- == 0) {
+      SPI1->CR2 |= SPI_CR2_FRXTH;
+      return BSP_SPI_ERR_TIMEOUT;
+    }
   }
-  timeout = 1000000;
-  *(__IO uint8_t*)&SPI1->DR = 0x42;
 
-  while (n-- > 0) {
-    // Wait until incoming data has arrived.
-    while ((SPI1->SR & SPI_SR_RXNE_Msk) != SPI_SR_RXNE) {
-      if (timeout-- == 0) return 2;
+  // Odd length: the last byte alone, RXNE must trigger at one frame.
+  SPI1->CR2 |= SPI_CR2_FRXTH;
+  if ((length & 1U) != 0) {
+    *(__IO uint8_t*)&SPI1->DR = (tx != 0) ? tx[length - 1] : 0xFF;
+    SPI1_CrcNext();
+    while ((SPI1->SR & SPI_SR_RXNE) != SPI_SR_RXNE) {
+      if (timeout-- == 0) return BSP_SPI_ERR_TIMEOUT;
     }
-    timeout = 1000000;
-    *response = *(__IO uint8_t*)&SPI1->DR;
-    ++response;
+    value = *(__IO uint8_t*)&SPI1->DR;
+    if (rx != 0) rx[length - 1] = (uint8_t)value;
   }
 
-  // Release slave (CS --> high).
-  GPIOB->BSRR = GPIO_BSRR_BS_6;
+  return SPI1_CrcCheck();
+}
 
-  return 0;
+uint8_t BspSPI1_BMP390_Read(uint8_t register_address, uint8_t length,
+                            uint8_t* response) {
+  // Register address with the READ bit, followed by one dummy byte before the
+  // sensor sends data.
+  uint8_t header[2] = {(uint8_t)(register_address | 0x80), 0x00};
+  uint8_t result;
+
+  BspSPI1_Select(&bmp390_device);
+
+  result = BspSPI1_Transfer(header, 0, 2);
+  if (result == BSP_SPI_OK) result = BspSPI1_Transfer(0, response, length);
+
+  BspSPI1_Deselect(&bmp390_device);
+
+  return result;
 }
@@ -9,9 +9,34 @@
 
 #include "dac.h"
 
+#include <stdint.h>
+
 #include "stm32f303xe.h"
 #include "stm32f3xx.h"
 
+// TIM6 clock: PCLK1 x 2.
+#define DAC_WAVE_CLOCK_HZ 48000000U
+
+#define DAC_WAVE_HALF (BSP_DAC_WAVE_SAMPLES / 2)
+
+static uint16_t dac_wave_buffer[BSP_DAC_WAVE_SAMPLES];
+
+// Default refill: table, position and scaling. A new table waits in
+// `dac_wave_next` until the next refill.
+static const int16_t* dac_wave_table;
+static uint16_t dac_wave_length;
+static uint16_t dac_wave_position;
+static const int16_t* dac_wave_next;
+static uint16_t dac_wave_next_length;
+static uint8_t dac_wave_switch;
+static uint32_t dac_wave_amplitude;
+static uint16_t dac_wave_offset;
+
+static BspDacWaveFill dac_wave_fill;
+static void* dac_wave_context;
+
+static BspDacWaveStats dac_wave_stats;
+
 void BspDacInit(void) {
   // Enable GPIOA port clock for PA4.
   RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
@@ -27,3 +52,191 @@ void BspDacInit(void) {
   DAC1->CR &= 0x00000000;
   DAC1->CR |= DAC_CR_EN1;
 }
+
+/**
+ * @brief Default refill: the table in a loop, scaled.
+ */
+static void DacWaveTable(uint16_t* samples, uint16_t count) {
+  int32_t value;
+  uint16_t i;
+
+  if (dac_wave_switch) {
+    dac_wave_table = dac_wave_next;
+    dac_wave_length = dac_wave_next_length;
+    dac_wave_position = 0;
+    dac_wave_switch = 0;
+  }
+
+  for (i = 0; i < count; ++i) {
+    value = dac_wave_offset;
+    if (dac_wave_length > 0) {
+      value += (int32_t)(((int64_t)dac_wave_table[dac_wave_position] *
+                          dac_wave_amplitude) >>
+                         16);
+      if (++dac_wave_position == dac_wave_length) dac_wave_position = 0;
+    }
+    if (value < 0) value = 0;
+    if (value > 4095) value = 4095;
+    samples[i] = (uint16_t)value;
+  }
+}
+
+static void DacWaveRefill(uint16_t* samples) {
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles;
+
+  if (dac_wave_fill != 0) {
+    dac_wave_fill(samples, DAC_WAVE_HALF, dac_wave_context);
+  } else {
+    DacWaveTable(samples, DAC_WAVE_HALF);
+  }
+  cycles = DWT->CYCCNT - start;
+  dac_wave_stats.cycles_last = cycles;
+  if (cycles > dac_wave_stats.cycles_max) dac_wave_stats.cycles_max = cycles;
+  ++dac_wave_stats.refills;
+}
+
+void BspDacWaveInit(void) {
+  // 1. PA4 analog, DAC1 channel 1 with output buffer.
+  BspDacInit();
+
+  // Conversion on TIM6 TRGO (TSEL1 0b000), sample from DMA.
+  DAC1->CR = (0x00 << DAC_CR_TSEL1_Pos) | DAC_CR_TEN1 | DAC_CR_DMAEN1;
+  DAC1->CR |= DAC_CR_EN1;
+
+  // 2. Configure timer 6, TRGO on update (MMS 0b010).
+  RCC->APB1ENR |= RCC_APB1ENR_TIM6EN;
+  TIM6->CR1 = 0x0000;
+  TIM6->CR2 = (0x02 << TIM_CR2_MMS_Pos);
+  TIM6->DIER = 0x0000;
+  TIM6->CR1 = TIM_CR1_ARPE;
+  (void)BspDacWaveSetRate(48000, 0);
+  TIM6->EGR = TIM_EGR_UG;
+  TIM6->SR = 0;
+
+  // 3. DMA2 channel 3 (DAC1_CH1): memory to peripheral, 16 bit, circular,
+  // half and full transfer interrupts.
+  RCC->AHBENR |= RCC_AHBENR_DMA2EN;
+  DMA2_Channel3->CCR = 0;
+  DMA2_Channel3->CPAR = (uint32_t)&DAC1->DHR12R1;
+  DMA2_Channel3->CMAR = (uint32_t)dac_wave_buffer;
+  DMA2_Channel3->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_CIRC |
+                       DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_PL_1 |
+                       DMA_CCR_HTIE | DMA_CCR_TCIE;
+  NVIC_SetPriority(DMA2_Channel3_IRQn, 6);
+  NVIC_EnableIRQ(DMA2_Channel3_IRQn);
+
+  // Refill cycles are counted with the DWT cycle counter.
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  // 4. Default refill: mid-scale, no table.
+  dac_wave_table = 0;
+  dac_wave_length = 0;
+  dac_wave_switch = 0;
+  dac_wave_amplitude = 65536;
+  dac_wave_offset = 2048;
+  dac_wave_fill = 0;
+  dac_wave_stats = (BspDacWaveStats){0};
+}
+
+uint8_t BspDacWaveSetRate(uint32_t rate_hz, uint32_t* actual_hz) {
+  uint32_t ticks;
+  uint32_t prescaler;
+  uint32_t reload;
+
+  if ((rate_hz == 0) || (rate_hz > BSP_DAC_WAVE_RATE_MAX)) {
+    return BSP_DAC_ERR_RANGE;
+  }
+
+  // Timer clocks per sample, rounded; prescaled to fit the 16-bit counter.
+  ticks = (DAC_WAVE_CLOCK_HZ + rate_hz / 2) / rate_hz;
+  prescaler = (ticks - 1) / 0x10000;
+  reload = (ticks + prescaler / 2) / (prescaler + 1);
+
+  // Both preloaded, they apply together at the next update.
+  TIM6->PSC = (uint16_t)prescaler;
+  TIM6->ARR = (uint16_t)(reload - 1);
+  if (actual_hz != 0) {
+    *actual_hz = DAC_WAVE_CLOCK_HZ / ((prescaler + 1) * reload);
+  }
+  return BSP_DAC_OK;
+}
+
+void BspDacWaveSetTable(const int16_t* table, uint16_t length) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  dac_wave_next = table;
+  dac_wave_next_length = (table != 0) ? length : 0;
+  dac_wave_switch = 1;
+  __set_PRIMASK(primask);
+}
+
+void BspDacWaveSetAmplitude(uint32_t amplitude, uint16_t offset) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  dac_wave_amplitude = (amplitude > 65536) ? 65536 : amplitude;
+  dac_wave_offset = (offset > 4095) ? 4095 : offset;
+  __set_PRIMASK(primask);
+}
+
+void BspDacWaveSetFill(BspDacWaveFill fill, void* context) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  dac_wave_fill = fill;
+  dac_wave_context = context;
+  __set_PRIMASK(primask);
+}
+
+void BspDacWaveStart(void) {
+  BspDacWaveStop();
+  DacWaveRefill(&dac_wave_buffer[0]);
+  DacWaveRefill(&dac_wave_buffer[DAC_WAVE_HALF]);
+
+  DMA2_Channel3->CNDTR = BSP_DAC_WAVE_SAMPLES;
+  DMA2->IFCR = DMA_IFCR_CGIF3;
+  DAC1->SR = DAC_SR_DMAUDR1;
+  DMA2_Channel3->CCR |= DMA_CCR_EN;
+  TIM6->CNT = 0;
+  TIM6->CR1 |= TIM_CR1_CEN;
+}
+
+void BspDacWaveStop(void) {
+  TIM6->CR1 &= ~TIM_CR1_CEN;
+  DMA2_Channel3->CCR &= ~DMA_CCR_EN;
+}
+
+void BspDacWaveGetStats(BspDacWaveStats* stats) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *stats = dac_wave_stats;
+  __set_PRIMASK(primask);
+}
+
+void DMA2_Channel3_IRQHandler(void) {
+  uint32_t status = DMA2->ISR;
+
+  DMA2->IFCR = DMA_IFCR_CGIF3;
+
+  // Both flags: the interrupt was delayed past the next boundary, the half
+  // due now is being played already.
+  if ((status & (DMA_ISR_HTIF3 | DMA_ISR_TCIF3)) ==
+      (DMA_ISR_HTIF3 | DMA_ISR_TCIF3)) {
+    ++dac_wave_stats.late;
+  }
+  // Half transfer: the first half is done, refill it while the second
+  // plays. Full transfer: the other way round.
+  if ((status & DMA_ISR_HTIF3) != 0) DacWaveRefill(&dac_wave_buffer[0]);
+  if ((status & DMA_ISR_TCIF3) != 0) {
+    DacWaveRefill(&dac_wave_buffer[DAC_WAVE_HALF]);
+  }
+
+  if ((DAC1->SR & DAC_SR_DMAUDR1) != 0) {
+    DAC1->SR = DAC_SR_DMAUDR1;
+    ++dac_wave_stats.underruns;
+  }
+}
@@ -0,0 +1,227 @@
+/**
+ * @file dds.c
+ * @author DFlubacher
+ * @brief Direct digital synthesis of sine tones and linear chirps.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "dds.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#define DDS_LUT_BITS 8
+#define DDS_LUT_SIZE (1 << DDS_LUT_BITS)
+
+// Setting groups changed since the filling took them.
+#define DDS_FREQUENCY 0x01
+#define DDS_LEVEL 0x02
+
+// Setter / filling handover, see `BspDds.sequence`.
+#define DDS_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_ACQUIRE)
+#define DDS_STORE(counter, value) \
+  __atomic_store_n(&(counter), (value), __ATOMIC_RELEASE)
+
+// Sine, Q15 value in the upper and slope to the next entry in the lower
+// half. CCM RAM without a flash image (NOLOAD), see `BspDdsInit()`.
+static int32_t dds_lut[DDS_LUT_SIZE]
+    __attribute__((section(".ccmram.noinit")));
+static uint8_t dds_lut_ready;
+
+static void DdsLutInit(void) {
+  int32_t values[DDS_LUT_SIZE];
+  int32_t slope;
+  uint16_t i;
+
+  for (i = 0; i < DDS_LUT_SIZE; ++i) {
+    values[i] = (int32_t)lroundf(32767.0f *
+                                 sinf(6.2831853f * i / (float)DDS_LUT_SIZE));
+  }
+  for (i = 0; i < DDS_LUT_SIZE; ++i) {
+    slope = values[(i + 1) % DDS_LUT_SIZE] - values[i];
+    dds_lut[i] = (int32_t)((uint32_t)values[i] << 16) | (uint16_t)slope;
+  }
+  dds_lut_ready = 1;
+}
+
+/**
+ * @brief Sample at `phase`: the upper bits select the entry, the next 16
+ * bits interpolate along its slope. Scaled to 12 bit, rounded. Inlined into
+ * the loops also at -Og.
+ */
+static inline __attribute__((always_inline)) uint16_t DdsSample(
+    uint32_t phase, int32_t gain, int32_t offset) {
+  int32_t entry = dds_lut[phase >> (32 - DDS_LUT_BITS)];
+  int32_t fraction = (int32_t)((phase >> (16 - DDS_LUT_BITS)) & 0xFFFF);
+  int32_t value = (entry >> 16) + (((int16_t)entry * fraction) >> 16);
+
+  return (uint16_t)(offset + ((value * gain + (1 << 18)) >> 19));
+}
+
+/**
+ * @brief Phase increment per sample of `frequency_hz`, Q32.32.
+ */
+static uint64_t DdsIncrement(const BspDds* dds, float frequency_hz) {
+  double cycles;
+
+  if (frequency_hz <= 0.0f) return 0;
+  cycles = (double)frequency_hz / dds->rate_hz;
+  if (cycles > 0.5) cycles = 0.5;
+  return (uint64_t)(cycles * 18446744073709551616.0);
+}
+
+/**
+ * @brief Q15 gain of `amplitude` (0 ... 65536) around `offset` (0 ... 4095).
+ * The rounded swing (sine * gain + 2^18) >> 19 must stay within -offset ...
+ * 4095 - offset, there is no clipping per sample.
+ */
+static int32_t DdsGain(uint32_t amplitude, uint16_t offset) {
+  uint32_t gain;
+  uint32_t limit;
+
+  if (amplitude > 65536) amplitude = 65536;
+  gain = (amplitude + 1) / 2;
+
+  limit = (uint32_t)((((uint64_t)(4096 - offset) << 19) - (1 << 18) - 1) /
+                     32767);
+  if (gain > limit) gain = limit;
+  limit = (uint32_t)((((uint64_t)offset << 19) + (1 << 18)) / 32767);
+  if (gain > limit) gain = limit;
+  return (int32_t)gain;
+}
+
+static void DdsBeginWrite(BspDds* dds) {
+  DDS_STORE(dds->sequence, dds->sequence + 1);
+}
+
+static void DdsEndWrite(BspDds* dds, uint8_t changes) {
+  dds->changes |= changes;
+  DDS_STORE(dds->sequence, dds->sequence + 1);
+}
+
+/**
+ * @brief Take the settings changed by the setters, unless they are just
+ * writing. Called at the start of a block.
+ */
+static void DdsApply(BspDds* dds) {
+  uint32_t sequence = DDS_LOAD(dds->sequence);
+
+  if (((sequence & 1) != 0) || (sequence == dds->applied)) return;
+  if ((dds->changes & DDS_FREQUENCY) != 0) {
+    dds->active.increment = dds->pending.increment;
+    dds->active.sweep = dds->pending.sweep;
+    dds->active.start = dds->pending.start;
+    dds->active.samples = dds->pending.samples;
+    dds->active.repeat = dds->pending.repeat;
+    dds->remaining = dds->pending.samples;
+  }
+  if ((dds->changes & DDS_LEVEL) != 0) {
+    dds->active.gain = dds->pending.gain;
+    dds->active.offset = dds->pending.offset;
+  }
+  dds->changes = 0;
+  dds->applied = sequence;
+}
+
+void BspDdsInit(BspDds* dds, uint32_t rate_hz) {
+  if (!dds_lut_ready) DdsLutInit();
+
+  *dds = (BspDds){0};
+  dds->rate_hz = rate_hz;
+  dds->active.gain = DdsGain(65536, 2048);
+  dds->active.offset = 2048;
+  dds->pending = dds->active;
+}
+
+void BspDdsSetTone(BspDds* dds, float frequency_hz) {
+  DdsBeginWrite(dds);
+  dds->pending.increment = DdsIncrement(dds, frequency_hz);
+  dds->pending.sweep = 0;
+  dds->pending.start = dds->pending.increment;
+  dds->pending.samples = 0;
+  dds->pending.repeat = 0;
+  DdsEndWrite(dds, DDS_FREQUENCY);
+}
+
+void BspDdsSetChirp(BspDds* dds, float start_hz, float end_hz,
+                    float duration_s, uint8_t repeat) {
+  uint64_t start = DdsIncrement(dds, start_hz);
+  uint64_t end = DdsIncrement(dds, end_hz);
+  float samples = duration_s * (float)dds->rate_hz;
+
+  if (samples < 1.0f) samples = 1.0f;
+  if (samples > 4.0e9f) samples = 4.0e9f;
+
+  DdsBeginWrite(dds);
+  dds->pending.samples = (uint32_t)samples;
+  // Increments are below 2^63, their difference fits.
+  dds->pending.sweep =
+      ((int64_t)end - (int64_t)start) / (int64_t)dds->pending.samples;
+  dds->pending.start = start;
+  dds->pending.increment = start;
+  dds->pending.repeat = repeat;
+  DdsEndWrite(dds, DDS_FREQUENCY);
+}
+
+void BspDdsSetAmplitude(BspDds* dds, uint32_t amplitude, uint16_t offset) {
+  if (offset > 4095) offset = 4095;
+
+  DdsBeginWrite(dds);
+  dds->pending.gain = DdsGain(amplitude, offset);
+  dds->pending.offset = offset;
+  DdsEndWrite(dds, DDS_LEVEL);
+}
+
+void BspDdsFill(uint16_t* samples, uint16_t count, void* context) {
+  BspDds* dds = (BspDds*)context;
+  uint32_t phase;
+  uint64_t increment;
+  uint32_t step;
+  int64_t sweep;
+  int32_t gain;
+  int32_t offset;
+  uint32_t n;
+
+  DdsApply(dds);
+  phase = dds->phase;
+  increment = dds->active.increment;
+  sweep = dds->active.sweep;
+  gain = dds->active.gain;
+  offset = dds->active.offset;
+
+  while (count > 0) {
+    if (sweep == 0) {
+      // Tone (or the end of a chirp), constant increment.
+      step = (uint32_t)(increment >> 32);
+      for (; count > 0; --count) {
+        *samples++ = DdsSample(phase, gain, offset);
+        phase += step;
+      }
+      break;
+    }
+
+    // Chirp: up to its end, then start over or hold the end frequency.
+    n = (count < dds->remaining) ? count : dds->remaining;
+    count -= (uint16_t)n;
+    dds->remaining -= n;
+    for (; n > 0; --n) {
+      *samples++ = DdsSample(phase, gain, offset);
+      phase += (uint32_t)(increment >> 32);
+      increment += (uint64_t)sweep;
+    }
+    if (dds->remaining == 0) {
+      if (dds->active.repeat) {
+        increment = dds->active.start;
+        dds->remaining = dds->active.samples;
+      } else {
+        sweep = 0;
+        dds->active.sweep = 0;
+      }
+    }
+  }
+
+  dds->phase = phase;
+  dds->active.increment = increment;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file delay.c
+ * @author DFlubacher
+ * @brief Delay service: cycle loop, RTOS delay or WFI sleep.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "delay.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "bsp_timers.h"
+#include "stm32f3xx.h"
+#include "task.h"
+
+#define DELAY_ALARM_CHANNEL 1
+
+// Longest alarm, well within the half range of the 32-bit counter.
+#define DELAY_SLEEP_MAX_US 1000000000U
+
+// Iterations timed by the calibration.
+#define DELAY_CALIBRATION_LOOPS 1000U
+
+// Cycles per loop iteration in 1/256.
+static uint32_t delay_loop_cycles = 4U * 256U;
+static uint32_t delay_cycles_per_us = 48;
+
+static volatile uint8_t delay_expired;
+
+/**
+ * @brief The calibrated loop. Not inlined, so every call runs the same code.
+ */
+static void __attribute__((noinline)) DelayLoop(uint32_t loops) {
+  while (loops-- > 0) {
+    __NOP();
+  }
+}
+
+static void DelayExpired(void) { delay_expired = 1; }
+
+/**
+ * @brief Sleep until the timebase passes now + `delay_us`.
+ */
+static void DelaySleep(uint32_t delay_us) {
+  delay_expired = 0;
+  if (BspTimeAlarmStart(DELAY_ALARM_CHANNEL, BspTimeNow32() + delay_us,
+                        DelayExpired) != 0) {
+    return;
+  }
+
+  // With interrupts masked, an alarm arriving between the check and WFI
+  // still wakes the core. The handler runs when they are unmasked.
+  while (!delay_expired) {
+    __disable_irq();
+    if (!delay_expired) __WFI();
+    __enable_irq();
+  }
+}
+
+void BspDelayInit(void) {
+  uint32_t primask;
+  uint32_t start;
+  uint32_t cycles;
+
+  // The sleeping delays wait for a timebase alarm. Started here unless
+  // running already (a restart would reset the time).
+  if ((TIM2->CR1 & TIM_CR1_CEN) == 0) BspTimeInit();
+
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  delay_cycles_per_us = SystemCoreClock / 1000000U;
+
+  // Once to fill the prefetch buffer, then timed. An interrupt during the
+  // timed run would make every later delay short.
+  DelayLoop(DELAY_CALIBRATION_LOOPS);
+  primask = __get_PRIMASK();
+  __disable_irq();
+  start = DWT->CYCCNT;
+  DelayLoop(DELAY_CALIBRATION_LOOPS);
+  cycles = DWT->CYCCNT - start;
+  __set_PRIMASK(primask);
+
+  delay_loop_cycles = (cycles * 256U) / DELAY_CALIBRATION_LOOPS;
+  if (delay_loop_cycles == 0) delay_loop_cycles = 256;
+}
+
+void BspDelayUs(uint32_t delay_us) {
+  if (delay_us >= 1000) {
+    BspDelayMs((delay_us + 999) / 1000);
+    return;
+  }
+
+  DelayLoop((delay_us * delay_cycles_per_us * 256U) / delay_loop_cycles);
+}
+
+void BspDelayMs(uint32_t delay_ms) {
+  uint64_t remaining = (uint64_t)delay_ms * 1000U;
+  uint32_t delay_us;
+
+  if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+    // The current tick is partly over, one more makes it at least `delay_ms`.
+    vTaskDelay(pdMS_TO_TICKS(delay_ms) + 1);
+    return;
+  }
+
+  while (remaining > 0) {
+    delay_us = (remaining > DELAY_SLEEP_MAX_US) ? DELAY_SLEEP_MAX_US
+                                                : (uint32_t)remaining;
+    DelaySleep(delay_us);
+    remaining -= delay_us;
+  }
+}
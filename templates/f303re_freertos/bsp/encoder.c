@@ -0,0 +1,138 @@
+/**
+ * @file encoder.c
+ * @author DFlubacher
+ * @brief Quadrature encoder interface.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "encoder.h"
+
+#include <stdint.h>
+
+#include "bsp_timers.h"
+#include "stm32f3xx.h"
+
+static const BspEncoderPin encoder_tim3_pins[2] = {{GPIOB, 4, 2},
+                                                    {GPIOB, 5, 2}};
+static const BspEncoderPin encoder_tim4_pins[2] = {{GPIOA, 11, 10},
+                                                    {GPIOA, 12, 10}};
+
+/**
+ * @brief Alternate function with pull-up.
+ */
+static void EncoderPinInit(const BspEncoderPin* pin) {
+  uint32_t shift = 4 * (pin->pin % 8);
+
+  if (pin->port == GPIOA) RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
+  if (pin->port == GPIOB) RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
+  if (pin->port == GPIOC) RCC->AHBENR |= RCC_AHBENR_GPIOCEN;
+  if (pin->port == GPIOD) RCC->AHBENR |= RCC_AHBENR_GPIODEN;
+
+  pin->port->MODER &= ~(0x03UL << (2 * pin->pin));
+  pin->port->MODER |= (0x02UL << (2 * pin->pin));
+  pin->port->PUPDR &= ~(0x03UL << (2 * pin->pin));
+  pin->port->PUPDR |= (0x01UL << (2 * pin->pin));
+  pin->port->AFR[pin->pin / 8] &= ~(0x0FUL << shift);
+  pin->port->AFR[pin->pin / 8] |= ((uint32_t)pin->af << shift);
+}
+
+uint8_t BspEncoderInit(BspEncoder* encoder, TIM_TypeDef* timer,
+                       uint8_t filter, const BspEncoderPin* pins) {
+  uint8_t i;
+
+  // 1. Enable the timer, pick the default pins.
+  if (timer == TIM3) {
+    RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+    if (pins == 0) pins = encoder_tim3_pins;
+  } else if (timer == TIM4) {
+    RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+    if (pins == 0) pins = encoder_tim4_pins;
+  } else {
+    return BSP_ENCODER_ERR_TIMER;
+  }
+
+  // 2. Configure the pins.
+  EncoderPinInit(&pins[0]);
+  EncoderPinInit(&pins[1]);
+
+  // 3. Configure the timer.
+  timer->CR1 = 0x0000;
+  timer->CR2 = 0x0000;
+  timer->DIER = 0x0000;
+  timer->CCER = 0x0000;
+  timer->PSC = 0;
+  timer->ARR = 0xFFFF;
+
+  // CC1: input on TI1, CC2: input on TI2, both filtered.
+  filter &= 0x0F;
+  timer->CCMR1 = (0x01 << TIM_CCMR1_CC1S_Pos) | (0x01 << TIM_CCMR1_CC2S_Pos) |
+                 ((uint32_t)filter << TIM_CCMR1_IC1F_Pos) |
+                 ((uint32_t)filter << TIM_CCMR1_IC2F_Pos);
+  timer->CCMR2 = 0x0000;
+
+  // Encoder mode 3 (0b011): count on both edges of TI1 and TI2. CCER
+  // polarity bits are left at non-inverted; swap the pins to reverse.
+  timer->SMCR = (0x03 << TIM_SMCR_SMS_Pos);
+
+  timer->EGR = TIM_EGR_UG;
+  timer->SR = 0;
+  timer->CNT = 0;
+
+  // 4. Start from position 0, an empty window.
+  encoder->timer = timer;
+  encoder->count = 0;
+  encoder->next = 0;
+  encoder->samples = 0;
+  for (i = 0; i < BSP_ENCODER_WINDOW; ++i) {
+    encoder->positions[i] = 0;
+    encoder->times_us[i] = 0;
+  }
+  encoder->reading = (BspEncoderReading){0};
+
+  timer->CR1 = TIM_CR1_CEN;
+  return BSP_ENCODER_OK;
+}
+
+void BspEncoderSample(BspEncoder* encoder) {
+  BspEncoderReading* reading = &encoder->reading;
+  uint32_t primask = __get_PRIMASK();
+  uint16_t count;
+  uint64_t now;
+  uint8_t oldest;
+
+  // Counter and timestamp as close together as possible, and the reading
+  // updated in one piece for `BspEncoderRead()`.
+  __disable_irq();
+  count = (uint16_t)encoder->timer->CNT;
+  now = BspTimeNowUs();
+
+  // The difference of the 16-bit counters is the movement if it is below
+  // half the counter range.
+  reading->position += (int16_t)(uint16_t)(count - encoder->count);
+  encoder->count = count;
+
+  // The oldest sample in the window, or the first sample while filling it.
+  oldest = (encoder->samples < BSP_ENCODER_WINDOW) ? 0 : encoder->next;
+  if ((encoder->samples > 0) && (now != encoder->times_us[oldest])) {
+    reading->velocity =
+        (float)(reading->position - encoder->positions[oldest]) * 1e6f /
+        (float)(now - encoder->times_us[oldest]);
+  }
+  reading->timestamp_us = now;
+
+  encoder->positions[encoder->next] = reading->position;
+  encoder->times_us[encoder->next] = now;
+  encoder->next = (uint8_t)((encoder->next + 1) % BSP_ENCODER_WINDOW);
+  if (encoder->samples < BSP_ENCODER_WINDOW) ++encoder->samples;
+  __set_PRIMASK(primask);
+}
+
+void BspEncoderRead(const BspEncoder* encoder, BspEncoderReading* reading) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *reading = encoder->reading;
+  __set_PRIMASK(primask);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file bmp390.h
+ * @author DFlubacher
+ * @brief BMP390 pressure sensor on the SPI1 bus, streaming through the FIFO.
+ * @version 0.1
+ * @date 2026-10-19
+ * References:
+ * - Bosch BMP390 data sheet, BST-BMP390-DS002.
+ *
+ * The sensor runs in normal mode and stores pressure/temperature frames in
+ * its 512 byte FIFO. `BspBmp390Poll()` drains the FIFO in one burst transfer,
+ * compensates each frame (single precision) and publishes timestamped samples
+ * to a queue. The frame timestamps are reconstructed from the drain time and
+ * the output data rate.
+ *
+ * Single sensor, FreeRTOS task context (uses the SPI bus manager). Timestamps
+ * need the timebase, see `BspTimeInit()`.
+ *
+ */
+
+#ifndef BSP_INCLUDE_BMP390_H_
+#define BSP_INCLUDE_BMP390_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "comms.h"
+#include "queue.h"
+
+/**
+ * @brief Return codes.
+ * - BSP_BMP390_ERR_BUS: SPI bus transaction failed.
+ * - BSP_BMP390_ERR_CHIP_ID: no BMP390 found (chip id 0x60).
+ * - BSP_BMP390_ERR_CONFIG: the conversion time of the oversampling settings
+ *   exceeds the output data period, or the sensor flagged a config error.
+ */
+#define BSP_BMP390_OK 0
+#define BSP_BMP390_ERR_BUS 1
+#define BSP_BMP390_ERR_CHIP_ID 2
+#define BSP_BMP390_ERR_CONFIG 3
+
+/**
+ * @brief Output data rate, period 5 ms * 2^odr.
+ */
+#define BSP_BMP390_ODR_200HZ 0x00
+#define BSP_BMP390_ODR_100HZ 0x01
+#define BSP_BMP390_ODR_50HZ 0x02
+#define BSP_BMP390_ODR_25HZ 0x03
+#define BSP_BMP390_ODR_12P5HZ 0x04
+
+/**
+ * @brief Oversampling, 2^osr samples per conversion.
+ */
+#define BSP_BMP390_OSR_X1 0x00
+#define BSP_BMP390_OSR_X2 0x01
+#define BSP_BMP390_OSR_X4 0x02
+#define BSP_BMP390_OSR_X8 0x03
+#define BSP_BMP390_OSR_X16 0x04
+#define BSP_BMP390_OSR_X32 0x05
+
+/**
+ * @brief IIR filter coefficient 2^iir - 1 (0: bypass ... 7: 127).
+ */
+#define BSP_BMP390_IIR_BYPASS 0x00
+#define BSP_BMP390_IIR_1 0x01
+#define BSP_BMP390_IIR_3 0x02
+#define BSP_BMP390_IIR_7 0x03
+
+typedef struct {
+  uint8_t odr;
+  uint8_t osr_pressure;
+  uint8_t osr_temperature;
+  uint8_t iir;
+} BspBmp390Config;
+
+/**
+ * @brief Compensated sample.
+ * - timestamp_us: estimated end of conversion, `BspTimeNowUs()` timebase.
+ * - pressure: Pa.
+ * - temperature: degree Celsius.
+ */
+typedef struct {
+  uint64_t timestamp_us;
+  float pressure;
+  float temperature;
+} BspBmp390Sample;
+
+typedef struct {
+  // Samples published.
+  uint32_t samples;
+  // Samples lost because the queue was full.
+  uint32_t dropped;
+  // FIFO drains.
+  uint32_t polls;
+  // Bus errors while draining.
+  uint32_t errors;
+} BspBmp390Stats;
+
+/**
+ * @brief Register `device` on the SPI bus, check the chip id, soft reset and
+ * read the calibration coefficients. The sensor is left in sleep mode.
+ * The bus manager must be initialized (`BspSpiBusInit()`).
+ *
+ * @param device e.g. mode 0 (or 3), 10 MHz, 8 bit frames.
+ * @return uint8_t BSP_BMP390_OK or BSP_BMP390_ERR_xxx.
+ */
+uint8_t BspBmp390Init(const BspSpiDevice* device);
+
+/**
+ * @brief Set data rate, oversampling and filter, enable the FIFO (pressure
+ * and temperature frames) and start normal mode.
+ * 200 Hz is only possible with x1 oversampling of both channels.
+ *
+ * @param config
+ * @return uint8_t BSP_BMP390_OK or BSP_BMP390_ERR_xxx.
+ */
+uint8_t BspBmp390Configure(const BspBmp390Config* config);
+
+/**
+ * @brief Drain the FIFO and send the compensated samples to `queue` (item
+ * size sizeof(BspBmp390Sample), no blocking). The FIFO holds 73 frames,
+ * 365 ms at 200 Hz.
+ *
+ * @param queue
+ * @return uint8_t BSP_BMP390_OK or BSP_BMP390_ERR_BUS.
+ */
+uint8_t BspBmp390Poll(QueueHandle_t queue);
+
+/**
+ * @brief Task body draining the FIFO every 50 ms into the queue passed as
+ * `pv_parameters`. Configure the sensor before the task is created.
+ *
+ * @param pv_parameters QueueHandle_t of BspBmp390Sample.
+ */
+void BspBmp390Task(void* pv_parameters);
+
+/**
+ * @brief
+ * @return const BspBmp390Stats*
+ */
+const BspBmp390Stats* BspBmp390GetStats(void);
+
+#endif /* BSP_INCLUDE_BMP390_H_ */
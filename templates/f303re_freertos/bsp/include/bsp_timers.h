@@ -28,16 +28,14 @@
 void BspTimer6TimeBaseInit(uint16_t prescaler, uint16_t interval);
 
 /**
- * @brief Timer 6 Init, clocked at 48MHz (PCLK1, APB1 prescaler is /2,
- * therefore it is multiplied by 2 again, see Fig. 13.
- * Mode: Busy delay (bad practice, only for demo).
- * Prescaler: 48000 --> resolution: 1ms.
- * Auto-reload set to max.
+ * @brief Former busy delay on timer 6, now `BspDelayInit()`. TIM6 is no longer
+ * touched, it stays available for `BspTimer6TimeBaseInit()`.
  */
 void BspTimer6DelayInit(void);
 
 /**
- * @brief Delay with busy waiting (bad practice, only for demo).
+ * @brief Former busy delay on timer 6, now `BspDelayMs()` (sleeps instead of
+ * polling the counter).
  *
  * @param delay_ms
  */
@@ -74,6 +72,7 @@ void BspTimer3InputCaptureDoubleEdgeInit(void);
  * @note:
  *    - maximum 65536 ms.
  *    - timer 3 is a 16-bit counter with 32-bit registers.
+ *    - pwm_input.h turns this pattern into a frequency/duty service.
  */
 void BspTimer3InputCaptureTimingInit(void);
 
@@ -86,9 +85,69 @@ void BspTimer3InputCaptureTimingInit(void);
  *   - TIM8_CH2 -> PA14 (AF5) -> Morpho Connector (CN7)-15.
  * Prescaler: 48 --> resolution: 1us.
  * Period: 11 ms.
+ * @note: period_ms up to 65 ms (16-bit ARR). pwm.h covers any frequency and
+ * resolution on all PWM capable timers, motor_pwm.h center-aligned
+ * complementary outputs with dead-time.
  * @param period_ms
  *
  */
 void BspTimer8PwmInit(uint16_t period_ms);
 
+// ////////////////////////////////////////////////////////////////////////////
+// Timebase
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Free-running microsecond timebase on timer 2 (32 bit), clocked at
+ * 48MHz (PCLK1 x 2, like TIM3/TIM6).
+ * Prescaler: 48 --> resolution: 1us, the counter wraps after 71.6 minutes.
+ * The update interrupt (priority 0, above configMAX_SYSCALL_INTERRUPT_PRIORITY)
+ * extends it to 64 bit.
+ * Call once before the first timestamp, e.g. right after the clock setup.
+ */
+void BspTimeInit(void);
+
+/**
+ * @brief Microseconds since `BspTimeInit()`, 64 bit (no wrap).
+ * Lock-free, callable from tasks and from any interrupt priority.
+ *
+ * @return uint64_t
+ */
+uint64_t BspTimeNowUs(void);
+
+/**
+ * @brief Raw counter, lower 32 bit of `BspTimeNowUs()`. Cheap, for intervals
+ * shorter than 71 minutes: `(uint32_t)(BspTimeNow32() - start)`.
+ *
+ * @return uint32_t
+ */
+uint32_t BspTimeNow32(void);
+
+/**
+ * @brief Alarm callback, runs in the TIM2 interrupt at priority 0: it must not
+ * call FreeRTOS functions.
+ */
+typedef void (*BspTimeCallback)(void);
+
+/**
+ * @brief One-shot alarm on a TIM2 compare channel when the counter
+ * (`BspTimeNow32()`) reaches `at`. Starting an armed channel replaces the
+ * alarm. Channel 1 is used by the delay service.
+ *
+ * @param channel 1 ... 4.
+ * @param at
+ * @param callback
+ * @return uint8_t 0 if armed, 1 if `at` has passed already (not armed, the
+ *         callback isn't called).
+ */
+uint8_t BspTimeAlarmStart(uint8_t channel, uint32_t at,
+                          BspTimeCallback callback);
+
+/**
+ * @brief Cancel the alarm of `channel`.
+ *
+ * @param channel 1 ... 4.
+ */
+void BspTimeAlarmStop(uint8_t channel);
+
 #endif /* BSP_INCLUDE_BSP_TIMERS_H_ */
\ No newline at end of file
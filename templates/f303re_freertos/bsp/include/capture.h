@@ -0,0 +1,96 @@
+/**
+ * @file capture.h
+ * @author DFlubacher
+ * @brief Pulse stream capture on TIM3 with DMA, no interrupt per edge.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Pin PB4 (AF2, TIM3_CH1, CN10-27, D5), like the TIM3 input capture demos,
+ * but at the full 48 MHz timer clock:
+ * - CC1 captures falling edges, CC2 (also mapped to TI1) rising edges.
+ * - Every CC1 capture requests a DMA burst (DCR/DMAR) that copies CCR1 and
+ *   CCR2 into a circular buffer on DMA1 channel 6. A pair is one period:
+ *   falling edge and the rising edge before it.
+ * - The DMA half/full transfer interrupts wake the consumer, once per half
+ *   buffer (BSP_CAPTURE_PAIRS / 2 periods).
+ *
+ * The 16-bit counter wraps after 1.365 ms, periods must be shorter (above
+ * 733 Hz). Single consumer task.
+ *
+ */
+
+#ifndef BSP_INCLUDE_CAPTURE_H_
+#define BSP_INCLUDE_CAPTURE_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+// Timer clock, unit of the decoded pulses.
+#define BSP_CAPTURE_CLOCK_HZ 48000000U
+
+// Periods in the circular buffer, even.
+#ifndef BSP_CAPTURE_PAIRS
+#define BSP_CAPTURE_PAIRS 128
+#endif
+
+/**
+ * @brief Decoded period, in timer clocks (1 / BSP_CAPTURE_CLOCK_HZ).
+ * - period: falling edge to falling edge.
+ * - width: high time, rising to falling edge.
+ */
+typedef struct {
+  uint16_t period;
+  uint16_t width;
+} BspCapturePulse;
+
+typedef struct {
+  // Periods decoded.
+  uint32_t pulses;
+  // The consumer fell more than half a buffer behind, the buffer was
+  // skipped (pulses lost).
+  uint32_t overruns;
+  // Half buffers completed by the DMA.
+  uint32_t halves;
+} BspCaptureStats;
+
+/**
+ * @brief Configure PB4, TIM3 and DMA1 channel 6 and start capturing.
+ */
+void BspCaptureInit(void);
+
+/**
+ * @brief Stop capturing (timer and DMA).
+ */
+void BspCaptureStop(void);
+
+/**
+ * @brief Decode the periods captured since the last call, non-blocking.
+ *
+ * @param pulses
+ * @param max
+ * @return uint16_t number of pulses written to `pulses`, the rest stays for
+ *         the next call.
+ */
+uint16_t BspCaptureRead(BspCapturePulse* pulses, uint16_t max);
+
+/**
+ * @brief Wait for the next half buffer (or `timeout`), then decode like
+ * `BspCaptureRead()`. Only one task may wait.
+ *
+ * @param pulses
+ * @param max
+ * @param timeout ticks.
+ * @return uint16_t
+ */
+uint16_t BspCaptureWait(BspCapturePulse* pulses, uint16_t max,
+                        TickType_t timeout);
+
+/**
+ * @brief Copy of the statistics.
+ *
+ * @param stats
+ */
+void BspCaptureGetStats(BspCaptureStats* stats);
+
+#endif /* BSP_INCLUDE_CAPTURE_H_ */
@@ -14,6 +14,59 @@
 
 #include <stdint.h>
 
+#include "regmap.h"
+#include "stm32f3xx.h"
+
+/**
+ * @brief Return codes of the I2C1 master functions.
+ * - BSP_I2C_ERR_ADDRESS: NACK or timeout before the first byte. Check wiring
+ *   and receiver address.
+ * - BSP_I2C_ERR_WRITE: NACK or timeout on a transmitted byte.
+ * - BSP_I2C_ERR_READ: NACK or timeout while receiving.
+ * - BSP_I2C_ERR_STOP: Stop detection failed.
+ */
+#define BSP_I2C_OK 0
+#define BSP_I2C_ERR_ADDRESS 1
+#define BSP_I2C_ERR_WRITE 2
+#define BSP_I2C_ERR_READ 3
+#define BSP_I2C_ERR_STOP 4
+
+/**
+ * @brief Segment flags, see `BspI2cSegment`.
+ * - BSP_I2C_SEG_WRITE: transmit `length` bytes from `data`.
+ * - BSP_I2C_SEG_READ: receive `length` bytes into `data`.
+ * - BSP_I2C_SEG_RESTART: issue a repeated START before this segment. A change
+ *   of direction always implies a repeated START.
+ */
+#define BSP_I2C_SEG_WRITE 0x00
+#define BSP_I2C_SEG_READ 0x01
+#define BSP_I2C_SEG_RESTART 0x02
+
+/**
+ * @brief One span of an I2C transaction. The driver transmits from or
+ * receives into `data` directly, there is no staging buffer.
+ */
+typedef struct {
+  uint8_t* data;
+  uint16_t length;
+  uint8_t flags;
+} BspI2cSegment;
+
+/**
+ * @brief I2C transaction descriptor: device address and a list of segments
+ * executed between one START and one STOP condition.
+ * Consecutive segments of the same direction without BSP_I2C_SEG_RESTART go
+ * out as a single bus transfer, e.g. a 2-byte register address followed by the
+ * payload. EEPROM random read:
+ *   { {address, 2, BSP_I2C_SEG_WRITE},
+ *     {data, n, BSP_I2C_SEG_READ | BSP_I2C_SEG_RESTART} }
+ */
+typedef struct {
+  uint8_t device_address;
+  const BspI2cSegment* segments;
+  uint8_t nsegments;
+} BspI2cTransaction;
+
 /**
  * @brief I2C initialization.
  * Pins: PB8, PB9, open-drain configuration
@@ -46,6 +99,10 @@ uint8_t BspI2C1_Read(uint8_t device_address, uint8_t register_address,
  * @brief Write `nbytes` from `buffer` to the register `register_address` of
  *        device with address `device_address`.
  *
+ *        Returns 1 if device address fails.
+ *        Returns 2 if transmission fails.
+ *        Returns 4 if Stop detection fails.
+ *
  * @param device_address
  * @param register_address
  * @param buffer
@@ -55,6 +112,85 @@ uint8_t BspI2C1_Read(uint8_t device_address, uint8_t register_address,
 uint8_t BspI2C1_Write(uint8_t device_address, uint8_t register_address,
                       uint8_t* buffer, uint8_t nbytes);
 
+/**
+ * @brief Execute the scatter-gather `transaction` on I2C1 (master, polling).
+ * The segments are walked in place. NBYTES/RELOAD are programmed per bus
+ * transfer, so transfers longer than 255 bytes are supported.
+ *
+ * @param transaction
+ * @return uint8_t BSP_I2C_OK or BSP_I2C_ERR_xxx.
+ */
+uint8_t BspI2C1_Transfer(const BspI2cTransaction* transaction);
+
+/**
+ * @brief I2C1 target (slave) mode, serving the register map `map` to a host
+ * at 7-bit address `own_address`. Replaces master operation of I2C1.
+ * Pins and timing as in `BspI2C1_Init()`.
+ *
+ * Protocol: a host write sets the register pointer (first byte) followed by
+ * optional data bytes, a host read returns consecutive registers starting at
+ * the pointer. Interrupt driven, no clock stretching (NOSTRETCH): the next
+ * byte is always preloaded into TXDR from the latched snapshot.
+ *
+ * @param own_address
+ * @param map
+ */
+void BspI2C1_TargetInit(uint8_t own_address, BspRegMap* map);
+
+/**
+ * @brief Return codes of the SPI1 transfer functions.
+ * - BSP_SPI_ERR_BUSY: a DMA transfer is still running.
+ * - BSP_SPI_ERR_TIMEOUT: the blocking transfer did not complete, it has been
+ *   aborted.
+ * - BSP_SPI_ERR_DMA: DMA transfer error (bad buffer address).
+ * - BSP_SPI_ERR_CRC: the CRC received after the data did not match.
+ */
+#define BSP_SPI_OK 0
+#define BSP_SPI_ERR_BUSY 1
+#define BSP_SPI_ERR_TIMEOUT 2
+#define BSP_SPI_ERR_DMA 3
+#define BSP_SPI_ERR_CRC 4
+
+/**
+ * @brief SPI modes, CPOL (bit 1) and CPHA (bit 0).
+ */
+#define BSP_SPI_MODE_0 0x00
+#define BSP_SPI_MODE_1 0x01
+#define BSP_SPI_MODE_2 0x02
+#define BSP_SPI_MODE_3 0x03
+
+/**
+ * @brief SPI1 device descriptor.
+ * - max_clock_hz: the fastest prescaler not exceeding it is used (48 MHz / 2
+ *   ... 48 MHz / 256).
+ * - mode: BSP_SPI_MODE_x.
+ * - frame_bits: 4 ... 16.
+ * - cs_port, cs_pin: active low chip select, e.g. GPIOB, 6.
+ * - crc_polynomial: 0 disables the hardware CRC, e.g. 0x07 (CRC-8) or 0x1021
+ *   (CRC-16-CCITT). Every transfer call then ends with the CRC: the
+ *   transmitted one is appended, the received one is verified.
+ * - crc_bits: 8 or 16, for frames up to 8 bits (larger frames always use a
+ *   16-bit CRC).
+ * - crc_errors: optional (may be NULL) error counter of this device.
+ */
+typedef struct {
+  uint32_t max_clock_hz;
+  uint8_t mode;
+  uint8_t frame_bits;
+  GPIO_TypeDef* cs_port;
+  uint8_t cs_pin;
+  uint16_t crc_polynomial;
+  uint8_t crc_bits;
+  volatile uint32_t* crc_errors;
+} BspSpiDevice;
+
+/**
+ * @brief Completion callback of `BspSPI1_TransferStart()`, called from the
+ * DMA interrupt (priority 6, FreeRTOS ...FromISR() functions are allowed).
+ * A new transfer may be started from within the callback.
+ */
+typedef void (*BspSpiCallback)(uint8_t status, void* context);
+
 /**
  * @brief SPI initialization.
  * Board:
@@ -62,9 +198,77 @@ uint8_t BspI2C1_Write(uint8_t device_address, uint8_t register_address,
  * - MISO: D12 --> PA6 (AF5, SPI1_MISO)
  * - MOSI: D11 --> PA7 (AF5, SPI1_MOSI)
  * - CS:   D10 --> PB6 (GPO)
+ * DMA: DMA1 channel 2 (SPI1_RX), channel 3 (SPI1_TX).
  */
 void BspSPI1_Init(void);
 
+/**
+ * @brief Configure the chip select pin of `device` as output, deselected.
+ *
+ * @param device
+ */
+void BspSPI1_DeviceInit(const BspSpiDevice* device);
+
+/**
+ * @brief Assert the chip select of `device`. SPI1 is reconfigured (clock,
+ * mode, frame size) only if the previous transaction was with another device.
+ * The transfer functions are used between `BspSPI1_Select()` and
+ * `BspSPI1_Deselect()`.
+ *
+ * @param device
+ */
+void BspSPI1_Select(const BspSpiDevice* device);
+
+/**
+ * @brief Wait for the end of the last frame and release the chip select of
+ * `device`.
+ *
+ * @param device
+ */
+void BspSPI1_Deselect(const BspSpiDevice* device);
+
+/**
+ * @brief Start a full-duplex DMA transfer of `length` bytes and return
+ * immediately. `callback` (may be NULL) is called on completion.
+ * - `tx` NULL: RX-only, 0xFF dummy bytes are transmitted.
+ * - `rx` NULL: TX-only, the received bytes are discarded.
+ * For frames above 8 bits, `tx`/`rx` point to half-words and `length` counts
+ * frames. The buffers must stay valid until completion. Chip select is up to
+ * the caller.
+ *
+ * @param tx
+ * @param rx
+ * @param length
+ * @param callback
+ * @param context passed to `callback`.
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_BUSY.
+ */
+uint8_t BspSPI1_TransferStart(const uint8_t* tx, uint8_t* rx, uint16_t length,
+                              BspSpiCallback callback, void* context);
+
+/**
+ * @brief Blocking variant of `BspSPI1_TransferStart()`. The bytes move back to
+ * back without CPU involvement, the caller polls for completion.
+ *
+ * @param tx
+ * @param rx
+ * @param length
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_xxx.
+ */
+uint8_t BspSPI1_Transfer(const uint8_t* tx, uint8_t* rx, uint16_t length);
+
+/**
+ * @brief
+ * @return uint8_t 1 while a DMA transfer is running.
+ */
+uint8_t BspSPI1_TransferBusy(void);
+
+/**
+ * @brief Cancel a running DMA transfer, the callback is not called. Frames
+ * already in the FIFOs are still shifted out.
+ */
+void BspSPI1_TransferAbort(void);
+
 /**
  * @brief Read Transaction
  * Tell the slave what operation to perform. First byte with:
@@ -83,9 +287,65 @@ void BspSPI1_Init(void);
  */
 uint8_t BspSPI1_SendReceive(uint8_t tx_byte);
 
+/**
+ * @brief Read `length` bytes from register `register_address` of the BMP390
+ * on CS PB6 (mode 0, 6 MHz, DMA).
+ *
+ * @param register_address
+ * @param length
+ * @param response
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_xxx.
+ */
 uint8_t BspSPI1_BMP390_Read(uint8_t register_address, uint8_t length,
                             uint8_t* response);
 
+/**
+ * @brief Exchange one 16-bit frame (DS = 16 bits, FRXTH = 1/2). The frame
+ * size of the selected device is restored by the next `BspSPI1_Select()`.
+ *
+ * @param tx_byte
+ * @return uint16_t received frame, 0 on timeout.
+ */
 uint16_t BspSPI1_SendReceive16(uint16_t tx_byte);
 
+/**
+ * @brief Polled full-duplex transfer of `count` 16-bit frames, one half-word
+ * DR access per frame, e.g. for 16-bit DAC/ADC chips. NULL `tx` sends 0xFFFF,
+ * NULL `rx` discards.
+ *
+ * @param tx
+ * @param rx
+ * @param count
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_TIMEOUT.
+ */
+uint8_t BspSPI1_Transfer16(const uint16_t* tx, uint16_t* rx, uint16_t count);
+
+/**
+ * @brief Polled full-duplex transfer of `length` 8-bit frames with back to
+ * back bytes: the TX FIFO is kept filled (FTLVL) while the RX FIFO is drained
+ * (FRLVL). For short transfers, where the DMA setup costs more than it saves.
+ * NULL `tx` sends 0xFF, NULL `rx` discards.
+ *
+ * @param tx
+ * @param rx
+ * @param length
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_TIMEOUT.
+ */
+uint8_t BspSPI1_TransferPolled(const uint8_t* tx, uint8_t* rx,
+                               uint16_t length);
+
+/**
+ * @brief Polled full-duplex transfer of `length` 8-bit frames using data
+ * packing: two frames per half-word DR access, halving the register accesses.
+ * Same bytes on the wire as an 8-bit transfer. NULL `tx` sends 0xFF, NULL `rx`
+ * discards.
+ *
+ * @param tx
+ * @param rx
+ * @param length
+ * @return uint8_t BSP_SPI_OK or BSP_SPI_ERR_TIMEOUT.
+ */
+uint8_t BspSPI1_TransferPacked(const uint8_t* tx, uint8_t* rx,
+                               uint16_t length);
+
 #endif /* BSP_INCLUDE_COMMS_H_ */
\ No newline at end of file
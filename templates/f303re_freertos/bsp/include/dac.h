@@ -1,7 +1,7 @@
 /**
  * @file dac.h
  * @author DFlubacher
- * @brief Simple DAC
+ * @brief Simple DAC and DMA waveform player
  * @version 0.1
  * @date 2022-04-28
  *
@@ -14,6 +14,45 @@
 
 #include <stdint.h>
 
+/**
+ * @brief Return codes.
+ * - BSP_DAC_ERR_RANGE: sample rate 0 or above BSP_DAC_WAVE_RATE_MAX.
+ */
+#define BSP_DAC_OK 0
+#define BSP_DAC_ERR_RANGE 1
+
+// Samples in the circular DMA buffer, two halves. One half lasts
+// BSP_DAC_WAVE_SAMPLES / 2 sample periods, the time a refill may take.
+#ifndef BSP_DAC_WAVE_SAMPLES
+#define BSP_DAC_WAVE_SAMPLES 256
+#endif
+
+// DAC1 with output buffer: 1 Msps.
+#define BSP_DAC_WAVE_RATE_MAX 1000000U
+
+/**
+ * @brief Refill callback: write `count` 12-bit samples (0 ... 4095) for the
+ * idle half of the buffer. Runs in the DMA interrupt (priority 6), may use
+ * FromISR functions.
+ */
+typedef void (*BspDacWaveFill)(uint16_t* samples, uint16_t count,
+                               void* context);
+
+typedef struct {
+  // Halves refilled.
+  uint32_t refills;
+  // The interrupt came after both halves were played, a half played twice.
+  uint32_t late;
+  // DAC DMA underruns: a trigger before the previous sample was delivered.
+  uint32_t underruns;
+  // CPU cycles of a refill of BSP_DAC_WAVE_SAMPLES / 2 samples. Cycles per
+  // sample: cycles_max / (BSP_DAC_WAVE_SAMPLES / 2); the refill alone keeps
+  // up with up to SystemCoreClock / cycles per sample (plus interrupt and
+  // DMA overhead, other interrupts).
+  uint32_t cycles_last;
+  uint32_t cycles_max;
+} BspDacWaveStats;
+
 /**
  * @brief Digital to Analog Output.
  * PA4 -> Arduino Connector A2, Morpho Connector CN7-32.
@@ -21,4 +60,70 @@
  */
 void BspDacInit(void);
 
-#endif /* BSP_INCLUDE_DAC_H_ */
\ No newline at end of file
+/**
+ * @brief Waveform player on DAC1 channel 1 (PA4). TIM6 TRGO triggers a
+ * conversion per sample, DMA2 channel 3 feeds DHR12R1 from a circular
+ * buffer (DMA1 channel 3 belongs to SPI1). The half and full transfer
+ * interrupts refill the half just played: from a user callback, or by
+ * default from a sample table, scaled by amplitude and offset.
+ *
+ * Sets up the hardware, stopped, 48 kHz, mid-scale. Uses TIM6 exclusively
+ * (not together with `BspTimer6TimeBaseInit()`), enables the DWT cycle
+ * counter.
+ */
+void BspDacWaveInit(void);
+
+/**
+ * @brief Sample rate, glitch-free at runtime (auto-reload preload).
+ *
+ * @param rate_hz 1 ... BSP_DAC_WAVE_RATE_MAX.
+ * @param actual_hz rate reached, may be NULL.
+ * @return uint8_t BSP_DAC_OK or BSP_DAC_ERR_RANGE.
+ */
+uint8_t BspDacWaveSetRate(uint32_t rate_hz, uint32_t* actual_hz);
+
+/**
+ * @brief Table played by the default refill, in a loop. The switch happens
+ * at the next half buffer, the new table starts at its first sample.
+ *
+ * @param table signed samples, full scale -2048 ... 2047. Kept by
+ *        reference, must stay valid while played.
+ * @param length
+ */
+void BspDacWaveSetTable(const int16_t* table, uint16_t length);
+
+/**
+ * @brief Scaling of the default refill: output = offset + sample *
+ * amplitude / 65536, clipped to 0 ... 4095. From the next half buffer on.
+ *
+ * @param amplitude 0 ... 65536 (x1).
+ * @param offset 0 ... 4095, 2048 is mid-scale.
+ */
+void BspDacWaveSetAmplitude(uint32_t amplitude, uint16_t offset);
+
+/**
+ * @brief Replace the default refill with `fill`, NULL restores it.
+ *
+ * @param fill
+ * @param context
+ */
+void BspDacWaveSetFill(BspDacWaveFill fill, void* context);
+
+/**
+ * @brief Fill both halves and start playing.
+ */
+void BspDacWaveStart(void);
+
+/**
+ * @brief Stop, the output keeps the last sample.
+ */
+void BspDacWaveStop(void);
+
+/**
+ * @brief Copy the statistics.
+ *
+ * @param stats
+ */
+void BspDacWaveGetStats(BspDacWaveStats* stats);
+
+#endif /* BSP_INCLUDE_DAC_H_ */
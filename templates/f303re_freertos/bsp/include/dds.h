@@ -0,0 +1,121 @@
+/**
+ * @file dds.h
+ * @author DFlubacher
+ * @brief Direct digital synthesis of sine tones and linear chirps.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * A 32-bit phase accumulator advances by a Q32.32 increment per sample
+ * (frequency resolution rate / 2^32, 0.011 mHz at 48 kHz). The upper 8 bits
+ * of the phase index a 256 entry sine table, the next 16 bits interpolate
+ * linearly to the following entry (error below 1/10 LSB of 12 bit). Each
+ * table entry holds the value and the slope to the next one, one load per
+ * sample. The table lives in CCM RAM: no wait states and no bus contention
+ * with the DAC DMA (which can't reach CCM RAM, the sample buffers must stay
+ * in SRAM). The table is in the NOLOAD section .ccmram.noinit (no flash
+ * image, not initialized at startup), `BspDdsInit()` computes it.
+ *
+ * `BspDdsFill()` has the signature of a DAC refill callback:
+ *
+ *   static BspDds dds;
+ *   BspDdsInit(&dds, 48000);
+ *   BspDdsSetTone(&dds, 1000.5f);
+ *   BspDacWaveInit();
+ *   BspDacWaveSetRate(48000, NULL);
+ *   BspDacWaveSetFill(BspDdsFill, &dds);
+ *   BspDacWaveStart();
+ *
+ * The refill cost in cycles per sample is in `BspDacWaveStats`. Settings
+ * change at the next block, phase continuous. Call the setters from one task
+ * (or with the filling stopped); they don't block the filling. No hardware
+ * access, the engine can be compiled and exercised on a host.
+ *
+ */
+
+#ifndef BSP_INCLUDE_DDS_H_
+#define BSP_INCLUDE_DDS_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Settings handed from the setters to the filling.
+ * - increment: phase per sample, Q32.32.
+ * - sweep: increment change per sample, 0 for a tone.
+ * - start, samples: chirp start increment and length, `repeat` restarts it,
+ *   else the end frequency is held.
+ * - gain: Q15 amplitude, limited to fit around `offset`.
+ */
+typedef struct {
+  uint64_t increment;
+  int64_t sweep;
+  uint64_t start;
+  uint32_t samples;
+  uint8_t repeat;
+  int32_t gain;
+  int32_t offset;
+} BspDdsSettings;
+
+typedef struct {
+  uint32_t rate_hz;
+  uint32_t phase;
+  // Settings in use and samples left in the current chirp.
+  BspDdsSettings active;
+  uint32_t remaining;
+  // Written by the setters. `sequence` is odd while they write, the filling
+  // takes the `changes` (DDS_FREQUENCY, DDS_LEVEL) of `pending` when it is
+  // even and has changed.
+  BspDdsSettings pending;
+  uint8_t changes;
+  uint32_t sequence;
+  uint32_t applied;
+} BspDds;
+
+/**
+ * @brief Compute the sine table (first call) and set up `dds`: silent
+ * (mid-scale), full amplitude.
+ *
+ * @param dds
+ * @param rate_hz sample rate.
+ */
+void BspDdsInit(BspDds* dds, uint32_t rate_hz);
+
+/**
+ * @brief Steady sine tone.
+ *
+ * @param dds
+ * @param frequency_hz 0 ... rate / 2.
+ */
+void BspDdsSetTone(BspDds* dds, float frequency_hz);
+
+/**
+ * @brief Linear chirp from `start_hz` to `end_hz` in `duration_s`.
+ *
+ * @param dds
+ * @param start_hz 0 ... rate / 2.
+ * @param end_hz 0 ... rate / 2.
+ * @param duration_s
+ * @param repeat 1: start over at the end, 0: hold `end_hz`.
+ */
+void BspDdsSetChirp(BspDds* dds, float start_hz, float end_hz,
+                    float duration_s, uint8_t repeat);
+
+/**
+ * @brief Output = offset + sine * amplitude / 65536. The amplitude is limited
+ * so the output stays within 0 ... 4095.
+ *
+ * @param dds
+ * @param amplitude 0 ... 65536 (2047 LSB at mid-scale).
+ * @param offset 0 ... 4095.
+ */
+void BspDdsSetAmplitude(BspDds* dds, uint32_t amplitude, uint16_t offset);
+
+/**
+ * @brief Compute the next `count` 12-bit samples, a `BspDacWaveFill`.
+ *
+ * @param samples
+ * @param count
+ * @param context the `BspDds`.
+ */
+void BspDdsFill(uint16_t* samples, uint16_t count, void* context);
+
+#endif /* BSP_INCLUDE_DDS_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file delay.h
+ * @author DFlubacher
+ * @brief Delays that don't poll a timer counter.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * - Below 1 ms: calibrated instruction loop (the wait is too short to switch
+ *   tasks or sleep).
+ * - Scheduler running: `vTaskDelay()`, other tasks run meanwhile.
+ * - Bare metal (before the scheduler starts or with it suspended): sleep with
+ *   WFI until a TIM2 compare interrupt (alarm channel 1).
+ *
+ * Needs `BspDelayInit()`, which also starts the timebase (`BspTimeInit()`)
+ * if it isn't running. Not for interrupt handlers or code running with
+ * interrupts disabled.
+ *
+ */
+
+#ifndef BSP_INCLUDE_DELAY_H_
+#define BSP_INCLUDE_DELAY_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Calibrate the delay loop against the DWT cycle counter (enables it)
+ * and start the timebase if it isn't running. Call again after a change of
+ * the system clock.
+ */
+void BspDelayInit(void);
+
+/**
+ * @brief Wait at least `delay_us` microseconds. From 1000 us on the delay is
+ * rounded up to milliseconds, see `BspDelayMs()`.
+ *
+ * @param delay_us
+ */
+void BspDelayUs(uint32_t delay_us);
+
+/**
+ * @brief Wait at least `delay_ms` milliseconds, yielding to other tasks or
+ * sleeping. With the scheduler running the delay ends on a tick, up to one
+ * tick late.
+ *
+ * @param delay_ms
+ */
+void BspDelayMs(uint32_t delay_ms);
+
+#endif /* BSP_INCLUDE_DELAY_H_ */
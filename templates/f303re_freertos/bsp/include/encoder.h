@@ -0,0 +1,121 @@
+/**
+ * @file encoder.h
+ * @author DFlubacher
+ * @brief Quadrature encoder interface on TIM3 and TIM4.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The timer counts in encoder mode 3 (SMS=011): both edges of both channels,
+ * 4 counts per encoder line, direction from the phase. Counting is done by
+ * the hardware only, there is no interrupt per edge or per overflow; the
+ * speed of the encoder costs no CPU time.
+ *
+ * `BspEncoderSample()` runs periodically (task, timer wheel callback, ...).
+ * It extends the 16-bit counter to a 32-bit position from the difference
+ * since the last sample, and derives the velocity from the positions and
+ * `BspTimeNowUs()` timestamps of the last BSP_ENCODER_WINDOW samples. The
+ * counter must not move by more than 32767 counts between samples, e.g.
+ * sample at least every 32 ms at 1 M counts/s.
+ *
+ * Default pins (NUCLEO-F303RE), pull-ups enabled:
+ * - TIM3: A on PB4 (CH1, D5), B on PB5 (CH2, D4), AF2.
+ * - TIM4: A on PA11 (CH1), B on PA12 (CH2), AF10.
+ * A timer used here is not available to its other users (TIM3 capture,
+ * PWM input, ...).
+ *
+ */
+
+#ifndef BSP_INCLUDE_ENCODER_H_
+#define BSP_INCLUDE_ENCODER_H_
+
+#include <stdint.h>
+
+#include "stm32f3xx.h"
+
+/**
+ * @brief Return codes.
+ * - BSP_ENCODER_ERR_TIMER: not TIM3 or TIM4.
+ */
+#define BSP_ENCODER_OK 0
+#define BSP_ENCODER_ERR_TIMER 1
+
+// Samples the velocity is averaged over: longer is smoother at low speed,
+// shorter follows faster. 1: difference to the previous sample only.
+#ifndef BSP_ENCODER_WINDOW
+#define BSP_ENCODER_WINDOW 4
+#endif
+
+/**
+ * @brief Input filter (IC1F/IC2F, RM0316 TIMx_CCMR1), samples at the 48 MHz
+ * timer clock an edge must be stable for. Longer filters reject more noise
+ * and limit the count rate.
+ */
+#define BSP_ENCODER_FILTER_NONE 0x0
+#define BSP_ENCODER_FILTER_2 0x1
+#define BSP_ENCODER_FILTER_4 0x2
+#define BSP_ENCODER_FILTER_8 0x3
+
+/**
+ * @brief Input pin of channel A or B.
+ */
+typedef struct {
+  GPIO_TypeDef* port;
+  uint8_t pin;
+  uint8_t af;
+} BspEncoderPin;
+
+/**
+ * @brief Result of the last sample.
+ * - position: counts since `BspEncoderInit()`, 4 per line.
+ * - velocity: counts/s over the sample window.
+ * - timestamp_us: time of the sample, `BspTimeNowUs()` timebase.
+ */
+typedef struct {
+  int32_t position;
+  float velocity;
+  uint64_t timestamp_us;
+} BspEncoderReading;
+
+typedef struct {
+  TIM_TypeDef* timer;
+  // Counter at the last sample.
+  uint16_t count;
+  // Positions and times of the last samples, `next` is the oldest.
+  int32_t positions[BSP_ENCODER_WINDOW];
+  uint64_t times_us[BSP_ENCODER_WINDOW];
+  uint8_t next;
+  uint8_t samples;
+  BspEncoderReading reading;
+} BspEncoder;
+
+/**
+ * @brief Configure the pins and `timer` in encoder mode and start counting
+ * from position 0.
+ *
+ * @param encoder
+ * @param timer TIM3 or TIM4.
+ * @param filter BSP_ENCODER_FILTER_xxx or another IC filter code (0 ... 15).
+ * @param pins channel A and B, NULL for the default pins.
+ * @return uint8_t BSP_ENCODER_OK or BSP_ENCODER_ERR_TIMER.
+ */
+uint8_t BspEncoderInit(BspEncoder* encoder, TIM_TypeDef* timer,
+                       uint8_t filter, const BspEncoderPin* pins);
+
+/**
+ * @brief Read the counter, update position and velocity. Call periodically
+ * from one context.
+ *
+ * @param encoder
+ */
+void BspEncoderSample(BspEncoder* encoder);
+
+/**
+ * @brief Result of the last sample, consistent even if the sampler runs in
+ * another task or an interrupt.
+ *
+ * @param encoder
+ * @param reading
+ */
+void BspEncoderRead(const BspEncoder* encoder, BspEncoderReading* reading);
+
+#endif /* BSP_INCLUDE_ENCODER_H_ */
@@ -0,0 +1,186 @@
+/**
+ * @file log_store.h
+ * @author DFlubacher
+ * @brief Append-only, log-structured record store on NOR flash.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The flash is used as a ring of pages. Records (length-prefixed byte
+ * strings) are collected in RAM page buffers, a full page is handed over to
+ * `BspLogService()`, which programs it and erases sectors ahead of the write
+ * position in the background. The producer only copies into RAM, it never
+ * waits for a program or erase cycle. If all page buffers are in use the
+ * record is dropped and counted. When the ring is full, the oldest sector is
+ * erased (overwritten).
+ *
+ * Page layout: header (magic 0x4C47, used bytes, sequence number) followed
+ * by records {length (16 bit), data}. After a reset `BspLogMount()` finds the
+ * write position from the sequence numbers.
+ *
+ * Producer (`BspLogAppend()`, `BspLogFlush()`) and service may run in
+ * different tasks, one of each. No hardware access, the flash is reached
+ * through `BspLogFlash`.
+ *
+ */
+
+#ifndef BSP_INCLUDE_LOG_STORE_H_
+#define BSP_INCLUDE_LOG_STORE_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Return codes.
+ * - BSP_LOG_ERR_FULL: no free page buffer, the record was dropped.
+ * - BSP_LOG_ERR_SIZE: record does not fit into a page.
+ * - BSP_LOG_ERR_FLASH: flash access failed.
+ * - BSP_LOG_END: no more records (reader).
+ */
+#define BSP_LOG_OK 0
+#define BSP_LOG_ERR_FULL 1
+#define BSP_LOG_ERR_SIZE 2
+#define BSP_LOG_ERR_FLASH 3
+#define BSP_LOG_END 4
+
+// Program unit of the flash.
+#define BSP_LOG_PAGE_SIZE 256
+
+// Page buffers in RAM. They must cover the data produced during one sector
+// erase (45 ms typical, up to 400 ms).
+#ifndef BSP_LOG_BUFFERS
+#define BSP_LOG_BUFFERS 8
+#endif
+
+// Sectors kept erased ahead of the write position.
+#ifndef BSP_LOG_ERASE_AHEAD
+#define BSP_LOG_ERASE_AHEAD 1
+#endif
+
+#define BSP_LOG_HEADER_SIZE 8
+
+// Largest record.
+#define BSP_LOG_RECORD_MAX (BSP_LOG_PAGE_SIZE - BSP_LOG_HEADER_SIZE - 2)
+
+/**
+ * @brief Flash access. `program` and `erase` only start the operation,
+ * `busy` reports its end. Functions return 0 on success.
+ * `size` and `sector_size` are multiples of BSP_LOG_PAGE_SIZE, at least
+ * BSP_LOG_ERASE_AHEAD + 2 sectors.
+ */
+typedef struct {
+  uint8_t (*read)(void* context, uint32_t address, uint8_t* data,
+                  uint32_t length);
+  uint8_t (*program)(void* context, uint32_t address, const uint8_t* data,
+                     uint32_t length);
+  uint8_t (*erase)(void* context, uint32_t address);
+  uint8_t (*busy)(void* context);
+  void* context;
+  uint32_t size;
+  uint32_t sector_size;
+} BspLogFlash;
+
+typedef struct {
+  // Records accepted.
+  uint32_t records;
+  // Records dropped, no page buffer.
+  uint32_t dropped;
+  uint32_t pages_programmed;
+  uint32_t sectors_erased;
+  // Pages lost to the ring wrapping over old data.
+  uint32_t pages_overwritten;
+  // Most page buffers in use at the same time.
+  uint32_t buffers_peak;
+  uint32_t flash_errors;
+} BspLogStats;
+
+typedef struct {
+  const BspLogFlash* flash;
+  uint8_t buffers[BSP_LOG_BUFFERS][BSP_LOG_PAGE_SIZE];
+  // Producer: bytes used in the page buffer being filled, 0 if none.
+  uint16_t fill;
+  // Pages sealed by the producer and programmed by the service, free running.
+  uint32_t sealed;
+  uint32_t programmed;
+  // Sequence number of the next page programmed.
+  uint32_t sequence;
+  // Next page to program, erased bytes from there on (sector aligned end).
+  uint32_t head;
+  uint32_t erased;
+  // Oldest page holding data and number of pages holding data.
+  uint32_t tail;
+  uint32_t pages;
+  BspLogStats stats;
+} BspLogStore;
+
+/**
+ * @brief Read position, see `BspLogReadBegin()`.
+ */
+typedef struct {
+  uint32_t address;
+  uint32_t pages;
+  uint16_t offset;
+  uint16_t used;
+} BspLogCursor;
+
+/**
+ * @brief Attach `flash` and find the write position by scanning the page
+ * headers. An erased flash yields an empty store.
+ *
+ * @param store
+ * @param flash
+ * @return uint8_t BSP_LOG_OK or BSP_LOG_ERR_FLASH.
+ */
+uint8_t BspLogMount(BspLogStore* store, const BspLogFlash* flash);
+
+/**
+ * @brief Producer: copy a record into the current page buffer. Never waits
+ * for the flash.
+ *
+ * @param store
+ * @param data
+ * @param length up to BSP_LOG_RECORD_MAX.
+ * @return uint8_t BSP_LOG_OK, BSP_LOG_ERR_FULL or BSP_LOG_ERR_SIZE.
+ */
+uint8_t BspLogAppend(BspLogStore* store, const void* data, uint16_t length);
+
+/**
+ * @brief Producer: hand a partially filled page over to the service, e.g.
+ * before power down.
+ *
+ * @param store
+ */
+void BspLogFlush(BspLogStore* store);
+
+/**
+ * @brief Background work: program sealed pages and erase ahead. Starts flash
+ * operations until the flash is busy or nothing is left to do, returns
+ * immediately otherwise. Call periodically (e.g. every tick) from a low
+ * priority task.
+ *
+ * @param store
+ * @return uint8_t pages still waiting to be programmed.
+ */
+uint8_t BspLogService(BspLogStore* store);
+
+/**
+ * @brief Start reading at the oldest record. Records appended later are not
+ * included.
+ *
+ * @param store
+ * @param cursor
+ */
+void BspLogReadBegin(const BspLogStore* store, BspLogCursor* cursor);
+
+/**
+ * @brief Read the next record. Records longer than `max` are truncated.
+ *
+ * @param store
+ * @param cursor
+ * @param data
+ * @param max
+ * @param length full record length.
+ * @return uint8_t BSP_LOG_OK, BSP_LOG_END or BSP_LOG_ERR_FLASH.
+ */
+uint8_t BspLogReadNext(const BspLogStore* store, BspLogCursor* cursor,
+                       uint8_t* data, uint16_t max, uint16_t* length);
+
+#endif /* BSP_INCLUDE_LOG_STORE_H_ */
@@ -0,0 +1,159 @@
+/**
+ * @file motor_pwm.h
+ * @author DFlubacher
+ * @brief Three-phase motor PWM on TIM8: center-aligned, complementary outputs
+ * with dead-time, break input and ADC sampling at the PWM midpoint.
+ * @version 0.1
+ * @date 2026-10-19
+ * References:
+ * - RM0316 21 (advanced-control timers TIM1/TIM8/TIM20), 15 (ADC).
+ *
+ * Timer: center-aligned mode 1, counting up to ARR and back down at 48 MHz,
+ * PWM mode 1 on CH1 ... CH3 (high side on while CNT < CCRx) with the
+ * complementary CHxN (low side) and a dead-time inserted at every switch.
+ *
+ * Sampling: CH4 (no pin) marks the counter peak, the middle of the low-side
+ * on time where low-side shunt currents are measured. OC4REF drives TRGO2,
+ * which starts an injected conversion sequence of up to 4 ADC1 channels.
+ * The end of the sequence calls the control callback with the samples; the
+ * duties it writes are loaded at the following counter valley. From trigger
+ * to new duty is always half a PWM period, as long as the callback returns
+ * before the valley (see `BspMotorPwmStats`).
+ *
+ * Break: an active low fault signal (e.g. from the gate driver) on BKIN
+ * switches all outputs off in hardware (MOE cleared), they stay off until
+ * `BspMotorPwmEnable()`.
+ *
+ * Pins (NUCLEO-F303RE, AF4): CH1 ... CH3 on PC6, PC7, PC8, CH1N ... CH3N on
+ * PC10, PC11, PC12, BKIN on PD2 (pull-up). ADC1 inputs 1 ... 4 on PA0 ...
+ * PA3 and 6 ... 9 on PC0 ... PC3 are set to analog, others must be
+ * configured by the caller (PA2/PA3 are the console UART on the NUCLEO).
+ * Uses TIM8 and ADC1 exclusively (not together with ws2812.h, pwm.h on TIM8
+ * or the TIM8 demo). Needs `BspDelayInit()` (ADC regulator start-up).
+ *
+ */
+
+#ifndef BSP_INCLUDE_MOTOR_PWM_H_
+#define BSP_INCLUDE_MOTOR_PWM_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Return codes.
+ * - BSP_MOTOR_PWM_ERR_RANGE: frequency, dead-time or channels out of range.
+ * - BSP_MOTOR_PWM_ERR_ADC: ADC calibration or enable timed out.
+ */
+#define BSP_MOTOR_PWM_OK 0
+#define BSP_MOTOR_PWM_ERR_RANGE 1
+#define BSP_MOTOR_PWM_ERR_ADC 2
+
+#define BSP_MOTOR_PWM_CLOCK_HZ 48000000U
+
+// Timer clocks the ADC trigger comes before the counter peak, centers the
+// first sampling window on the peak.
+#ifndef BSP_MOTOR_PWM_SAMPLE_LEAD
+#define BSP_MOTOR_PWM_SAMPLE_LEAD 4
+#endif
+
+// ADC interrupt priority. The callback may use FromISR functions at 5 and
+// above. Below 5 (e.g. 1) FreeRTOS critical sections don't delay it, then
+// it must not call FreeRTOS at all.
+#ifndef BSP_MOTOR_PWM_PRIORITY
+#define BSP_MOTOR_PWM_PRIORITY 6
+#endif
+
+/**
+ * @brief Control callback, runs in the ADC interrupt once per PWM period.
+ * `samples` are the conversions of `BspMotorPwmConfig.channels`, in order,
+ * 12 bit right aligned. Set new duties with `BspMotorPwmSetDuties()`.
+ */
+typedef void (*BspMotorPwmControl)(const uint16_t* samples, void* context);
+
+/**
+ * @brief Configuration.
+ * - frequency_hz: PWM frequency, 367 Hz ... 240 kHz.
+ * - dead_time_ns: up to 21 us, rounded up to the dead-time generator steps.
+ * - channels: ADC1 channels sampled at the peak, 1 ... 4 of them.
+ * - control: may be NULL (sampling only, `BspMotorPwmSamples()`).
+ */
+typedef struct {
+  uint32_t frequency_hz;
+  uint32_t dead_time_ns;
+  const uint8_t* channels;
+  uint8_t nchannels;
+  BspMotorPwmControl control;
+  void* context;
+} BspMotorPwmConfig;
+
+/**
+ * @brief Control loop timing, in timer clocks (1 / BSP_MOTOR_PWM_CLOCK_HZ)
+ * from the ADC trigger.
+ * - cycles: conversion sequences completed.
+ * - entry_max: interrupt entry (conversion time plus interrupt latency).
+ * - done_last, done_max: duties written (callback returned).
+ * - late: callback returned after the valley, the duties were applied half a
+ *   period later than normal.
+ * - breaks: break events.
+ */
+typedef struct {
+  uint32_t cycles;
+  uint32_t entry_max;
+  uint32_t done_last;
+  uint32_t done_max;
+  uint32_t late;
+  uint32_t breaks;
+} BspMotorPwmStats;
+
+/**
+ * @brief Configure pins, TIM8 and ADC1 and start the timer and the
+ * sampling. The outputs stay off (low) until `BspMotorPwmEnable()`, duties
+ * start at 50 %.
+ *
+ * @param config
+ * @return uint8_t BSP_MOTOR_PWM_OK or BSP_MOTOR_PWM_ERR_xxx.
+ */
+uint8_t BspMotorPwmInit(const BspMotorPwmConfig* config);
+
+/**
+ * @brief Duty range: duties are 0 (high side always off) ... period (high
+ * side always on).
+ *
+ * @return uint16_t
+ */
+uint16_t BspMotorPwmPeriod(void);
+
+/**
+ * @brief Duties of the three phases, applied together at the next counter
+ * valley (or peak). Normally called from the control callback.
+ *
+ * @param duties
+ */
+void BspMotorPwmSetDuties(const uint16_t* duties);
+
+/**
+ * @brief Switch the outputs on (main output enable), also after a break.
+ *
+ * @return uint8_t 0 if on, 1 if the break input is still active.
+ */
+uint8_t BspMotorPwmEnable(void);
+
+/**
+ * @brief Switch all outputs off (low).
+ */
+void BspMotorPwmDisable(void);
+
+/**
+ * @brief Latest conversions, for use without a control callback.
+ *
+ * @param samples BspMotorPwmConfig.nchannels values.
+ */
+void BspMotorPwmSamples(uint16_t* samples);
+
+/**
+ * @brief Copy the timing statistics.
+ *
+ * @param stats
+ */
+void BspMotorPwmGetStats(BspMotorPwmStats* stats);
+
+#endif /* BSP_INCLUDE_MOTOR_PWM_H_ */
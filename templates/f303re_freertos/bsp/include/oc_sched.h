@@ -0,0 +1,125 @@
+/**
+ * @file oc_sched.h
+ * @author DFlubacher
+ * @brief Timed GPIO edges and actions on the TIM2 timebase compare channels.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Events (time, action) are kept in a sorted queue per compare channel, the
+ * nearest one is armed on the channel (`BspTimeAlarmStart()`). Times are
+ * `BspTimeNow32()` values, up to 35 minutes ahead.
+ *
+ * - Channels 2 and 3 drive a pin: the compare match itself sets, clears or
+ *   toggles the output in hardware. The edge lands on the timebase tick,
+ *   synchronous to the 48 MHz timer clock, independent of interrupt latency.
+ *   Pins (AF1): CH2 on PA1 (A1), CH3 on PB10 (D6).
+ * - Channel 4 only calls functions.
+ * Every event may have a callback, called from the compare interrupt (TIM2,
+ * priority 0) after its edge. Callbacks must not call FreeRTOS functions,
+ * they may schedule further events.
+ *
+ * The callback latency (compare match to callback, in CPU cycles) is
+ * measured with the DWT cycle counter; its spread is the jitter of software
+ * actions. Events on one channel closer together than this latency are
+ * executed late, by software (counted in `BspOcSchedStats.late`). Channel 1
+ * stays with the delay service.
+ *
+ * The cycle counter stops while the core sleeps (WFI, e.g. the bare-metal
+ * `BspDelayMs()`) or a debugger halts it. Every latency sample first checks
+ * the counter against the timebase; after a stop the sample is dropped and
+ * the relation taken anew (`BspOcSchedStats.resyncs`).
+ *
+ */
+
+#ifndef BSP_INCLUDE_OC_SCHED_H_
+#define BSP_INCLUDE_OC_SCHED_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Return codes.
+ * - BSP_OC_SCHED_ERR_FULL: no free event, see BSP_OC_SCHED_EVENTS.
+ * - BSP_OC_SCHED_ERR_LATE: the time has passed already.
+ * - BSP_OC_SCHED_ERR_CHANNEL: not channel 2 ... 4, or a pin action on
+ *   channel 4.
+ */
+#define BSP_OC_SCHED_OK 0
+#define BSP_OC_SCHED_ERR_FULL 1
+#define BSP_OC_SCHED_ERR_LATE 2
+#define BSP_OC_SCHED_ERR_CHANNEL 3
+
+/**
+ * @brief Pin actions (output compare modes).
+ */
+#define BSP_OC_SCHED_NONE 0
+#define BSP_OC_SCHED_SET 1
+#define BSP_OC_SCHED_CLEAR 2
+#define BSP_OC_SCHED_TOGGLE 3
+
+// Events queued on all channels together.
+#ifndef BSP_OC_SCHED_EVENTS
+#define BSP_OC_SCHED_EVENTS 32
+#endif
+
+/**
+ * @brief Event callback, runs in the TIM2 interrupt at priority 0.
+ */
+typedef void (*BspOcSchedCallback)(void* context);
+
+/**
+ * @brief Counters and callback latency in CPU cycles (1 / SystemCoreClock)
+ * from the compare match. Jitter: latency_max - latency_min.
+ */
+typedef struct {
+  uint32_t scheduled;
+  uint32_t fired;
+  // Executed after their time, without a compare match.
+  uint32_t late;
+  // Rejected, no free event.
+  uint32_t full;
+  // Latency samples dropped, the cycle counter had stopped.
+  uint32_t resyncs;
+  uint32_t latency_min;
+  uint32_t latency_max;
+  uint32_t latency_last;
+} BspOcSchedStats;
+
+/**
+ * @brief Configure the pins (low) and channels 2 ... 4. Needs the timebase
+ * (`BspTimeInit()`), enables the DWT cycle counter.
+ */
+void BspOcSchedInit(void);
+
+/**
+ * @brief Queue an event. Callable from tasks and interrupts.
+ *
+ * @param channel 2 or 3 (pin), 4 (callback only).
+ * @param at `BspTimeNow32()` time.
+ * @param action BSP_OC_SCHED_xxx, BSP_OC_SCHED_NONE on channel 4.
+ * @param callback may be NULL.
+ * @param context passed to `callback`.
+ * @return uint8_t BSP_OC_SCHED_OK or BSP_OC_SCHED_ERR_xxx.
+ */
+uint8_t BspOcSchedAdd(uint8_t channel, uint32_t at, uint8_t action,
+                      BspOcSchedCallback callback, void* context);
+
+/**
+ * @brief Drop all events of `channel`, the pin keeps its level.
+ *
+ * @param channel 2 ... 4.
+ */
+void BspOcSchedClear(uint8_t channel);
+
+/**
+ * @brief Copy the statistics.
+ *
+ * @param stats
+ */
+void BspOcSchedGetStats(BspOcSchedStats* stats);
+
+/**
+ * @brief Clear the statistics, e.g. after start-up.
+ */
+void BspOcSchedResetStats(void);
+
+#endif /* BSP_INCLUDE_OC_SCHED_H_ */
@@ -0,0 +1,107 @@
+/**
+ * @file profile.h
+ * @author DFlubacher
+ * @brief Cycle-level profiling with the DWT cycle counter.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Named regions live in a fixed table. A region is measured between
+ * `BSP_PROFILE_BEGIN()` and `BSP_PROFILE_END()`, both inline (one counter read
+ * each, plus the min/max/sum update at the end). Example:
+ *
+ *   static uint8_t region_poll;
+ *   region_poll = BspProfileRegister("bmp390 poll");
+ *   ...
+ *   BSP_PROFILE_BEGIN(start);
+ *   BspBmp390Poll(queue);
+ *   BSP_PROFILE_END(region_poll, start);
+ *
+ *   BspProfileDump();
+ *
+ * Record a region from one context only (one task or one interrupt), the
+ * update is not atomic. Build with BSP_PROFILE=0 to remove all probes.
+ *
+ */
+
+#ifndef BSP_INCLUDE_PROFILE_H_
+#define BSP_INCLUDE_PROFILE_H_
+
+#include <stdint.h>
+
+#include "stm32f3xx.h"
+
+#ifndef BSP_PROFILE
+#define BSP_PROFILE 1
+#endif
+
+#ifndef BSP_PROFILE_REGIONS
+#define BSP_PROFILE_REGIONS 16
+#endif
+
+// Returned by `BspProfileRegister()` when the table is full. Recording to it
+// is ignored.
+#define BSP_PROFILE_NONE 0xFF
+
+typedef struct {
+  const char* name;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} BspProfileRegion;
+
+extern BspProfileRegion bsp_profile_regions[BSP_PROFILE_REGIONS];
+
+/**
+ * @brief Enable the DWT cycle counter and clear the table. Measures the cost
+ * of an empty BEGIN/END pair (reported by `BspProfileDump()`).
+ */
+void BspProfileInit(void);
+
+/**
+ * @brief Add a named region to the table.
+ *
+ * @param name kept by reference.
+ * @return uint8_t region index or BSP_PROFILE_NONE.
+ */
+uint8_t BspProfileRegister(const char* name);
+
+/**
+ * @brief Clear the statistics of all regions, names stay.
+ */
+void BspProfileReset(void);
+
+/**
+ * @brief Print the table to the console: count, min, max and mean in cycles
+ * and the mean in us. Regions may be recorded meanwhile, a line can then mix
+ * old and new values.
+ */
+void BspProfileDump(void);
+
+/**
+ * @brief Add a measurement of `cycles` to `region`.
+ *
+ * @param region
+ * @param cycles
+ */
+static inline void BspProfileRecord(uint8_t region, uint32_t cycles) {
+  BspProfileRegion* entry;
+
+  if (region >= BSP_PROFILE_REGIONS) return;
+  entry = &bsp_profile_regions[region];
+  if ((entry->count == 0) || (cycles < entry->min)) entry->min = cycles;
+  if (cycles > entry->max) entry->max = cycles;
+  entry->sum += cycles;
+  ++entry->count;
+}
+
+#if BSP_PROFILE
+#define BSP_PROFILE_BEGIN(start) const uint32_t start = DWT->CYCCNT
+#define BSP_PROFILE_END(region, start) \
+  BspProfileRecord((region), DWT->CYCCNT - (start))
+#else
+#define BSP_PROFILE_BEGIN(start) ((void)0)
+#define BSP_PROFILE_END(region, start) ((void)0)
+#endif
+
+#endif /* BSP_INCLUDE_PROFILE_H_ */
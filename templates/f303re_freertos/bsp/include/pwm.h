@@ -0,0 +1,111 @@
+/**
+ * @file pwm.h
+ * @author DFlubacher
+ * @brief PWM on TIM1, TIM2, TIM3, TIM4 and TIM8, any frequency and
+ * resolution, glitch-free updates.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * `BspPwmInit()` picks prescaler and auto-reload for the requested frequency
+ * with at least the requested number of duty steps: the smallest frequency
+ * error, then the finest resolution. Compare and auto-reload registers are
+ * preloaded, new values take effect at the next update event. Updates of
+ * several channels are held back until all are written (UDIS), so they
+ * apply in the same period.
+ *
+ * Default pins (NUCLEO-F303RE), `BspPwmChannelInit()` takes others:
+ * - TIM1: PC0, PC1, PC2, PC3 (AF2).
+ * - TIM2: PA0, PA1, PB10, PB11 (AF1).
+ * - TIM3: PB4, PB5, PB0, PB1 (AF2).
+ * - TIM4: PA11, PA12 (AF10), PB8, PB9 (AF2, shared with I2C1).
+ * - TIM8: PC6, PC7, PC8, PC9 (AF4).
+ * A timer used here is not available to its other users (TIM2 timebase,
+ * TIM3 capture, TIM8 LED chain, ...).
+ *
+ */
+
+#ifndef BSP_INCLUDE_PWM_H_
+#define BSP_INCLUDE_PWM_H_
+
+#include <stdint.h>
+
+#include "stm32f3xx.h"
+
+/**
+ * @brief Return codes.
+ * - BSP_PWM_ERR_TIMER: not one of the supported timers, or not initialized.
+ * - BSP_PWM_ERR_RANGE: frequency/resolution out of reach.
+ * - BSP_PWM_ERR_CHANNEL: channel not 1 ... 4.
+ */
+#define BSP_PWM_OK 0
+#define BSP_PWM_ERR_TIMER 1
+#define BSP_PWM_ERR_RANGE 2
+#define BSP_PWM_ERR_CHANNEL 3
+
+/**
+ * @brief Output pin of a channel.
+ */
+typedef struct {
+  GPIO_TypeDef* port;
+  uint8_t pin;
+  uint8_t af;
+} BspPwmPin;
+
+/**
+ * @brief Set up `timer` for PWM, all channels off. Duty cycles are given in
+ * 0 ... `steps` (0: always low, `steps`: always high).
+ *
+ * @param timer TIM1, TIM2, TIM3, TIM4 or TIM8.
+ * @param frequency_hz
+ * @param steps minimum resolution, e.g. 1000 for 0.1 %.
+ * @param actual_hz frequency reached, may be NULL.
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_xxx.
+ */
+uint8_t BspPwmInit(TIM_TypeDef* timer, uint32_t frequency_hz, uint32_t steps,
+                   uint32_t* actual_hz);
+
+/**
+ * @brief Change the frequency at the next update event, duty cycles are
+ * kept.
+ *
+ * @param timer
+ * @param frequency_hz
+ * @param actual_hz may be NULL.
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_xxx.
+ */
+uint8_t BspPwmSetFrequency(TIM_TypeDef* timer, uint32_t frequency_hz,
+                           uint32_t* actual_hz);
+
+/**
+ * @brief Configure the pin and enable the output of `channel`, duty 0.
+ *
+ * @param timer
+ * @param channel 1 ... 4.
+ * @param pin NULL for the default pin.
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_xxx.
+ */
+uint8_t BspPwmChannelInit(TIM_TypeDef* timer, uint8_t channel,
+                          const BspPwmPin* pin);
+
+/**
+ * @brief Duty cycle of one channel, from the next period on.
+ *
+ * @param timer
+ * @param channel 1 ... 4.
+ * @param duty 0 ... steps.
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_xxx.
+ */
+uint8_t BspPwmSetDuty(TIM_TypeDef* timer, uint8_t channel, uint32_t duty);
+
+/**
+ * @brief Duty cycles of several channels, all applied in the same period.
+ *
+ * @param timer
+ * @param duties duties[0] for channel 1 ... duties[3] for channel 4.
+ * @param mask bit 0 for channel 1 ... bit 3 for channel 4.
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_xxx.
+ */
+uint8_t BspPwmSetDuties(TIM_TypeDef* timer, const uint32_t* duties,
+                        uint8_t mask);
+
+#endif /* BSP_INCLUDE_PWM_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file pwm_input.h
+ * @author DFlubacher
+ * @brief Frequency and duty cycle measurement in PWM input mode on TIM3.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Pin PB4 (AF2, TIM3_CH1, CN10-27, D5). The pattern of
+ * `BspTimer3InputCaptureTimingInit()` with the edges swapped: a rising edge
+ * captures the period into CCR1 and resets the counter (slave reset mode on
+ * TI1FP1), the falling edge captures the high time into CCR2. One interrupt
+ * per period, plus one per counter overflow.
+ *
+ * The prescaler ranges automatically: the period is kept between 8192 and
+ * 65535 counts, from 48 MHz (21 ns resolution) down to 732 Hz (1.365 ms).
+ * Longer periods are extended by counting overflows, there is no upper limit
+ * up to BSP_PWM_INPUT_TIMEOUT_MS, after which "no signal" is published
+ * (within 1.4 ms: the prescaler is limited so no counter overflow is due
+ * after the timeout).
+ *
+ * Readings are filtered (first order, 1/2^BSP_PWM_INPUT_FILTER_SHIFT) and
+ * published to a one-element mailbox. Uses TIM3 and PB4 exclusively (not
+ * together with capture.h or the TIM3 demos).
+ *
+ */
+
+#ifndef BSP_INCLUDE_PWM_INPUT_H_
+#define BSP_INCLUDE_PWM_INPUT_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#define BSP_PWM_INPUT_CLOCK_HZ 48000000U
+
+#ifndef BSP_PWM_INPUT_FILTER_SHIFT
+#define BSP_PWM_INPUT_FILTER_SHIFT 2
+#endif
+
+// No rising edge for this long: "no signal".
+#ifndef BSP_PWM_INPUT_TIMEOUT_MS
+#define BSP_PWM_INPUT_TIMEOUT_MS 10000U
+#endif
+
+/**
+ * @brief Filtered reading.
+ * - period_clocks, high_clocks: in 1 / BSP_PWM_INPUT_CLOCK_HZ, 0: no signal.
+ * - frequency_hz, duty (0 ... 1): derived by `BspPwmInputRead()`.
+ * - periods: periods measured since the start.
+ * - timestamp_us: rising edge of the last period, `BspTimeNowUs()` timebase.
+ */
+typedef struct {
+  uint64_t timestamp_us;
+  uint64_t period_clocks;
+  uint64_t high_clocks;
+  float frequency_hz;
+  float duty;
+  uint32_t periods;
+} BspPwmInputReading;
+
+/**
+ * @brief Configure PB4 and TIM3 and start measuring.
+ */
+void BspPwmInputInit(void);
+
+/**
+ * @brief Stop measuring.
+ */
+void BspPwmInputStop(void);
+
+/**
+ * @brief Wait for the next reading.
+ *
+ * @param reading
+ * @param timeout ticks.
+ * @return uint8_t 0 if `reading` was updated, 1 on timeout.
+ */
+uint8_t BspPwmInputRead(BspPwmInputReading* reading, TickType_t timeout);
+
+#endif /* BSP_INCLUDE_PWM_INPUT_H_ */
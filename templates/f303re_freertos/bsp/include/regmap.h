@@ -0,0 +1,124 @@
+/**
+ * @file regmap.h
+ * @author DFlubacher
+ * @brief Double-buffered register map, served to an I2C host in target mode.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The map holds two banks. The application fills the back bank and commits
+ * it, the host is served from the front bank. Banks are only swapped at
+ * transaction boundaries (register pointer write, STOP), hence the host
+ * always reads a consistent frame.
+ *
+ * No hardware access, the logic can be compiled and exercised on a host.
+ *
+ */
+
+#ifndef BSP_INCLUDE_REGMAP_H_
+#define BSP_INCLUDE_REGMAP_H_
+
+#include <stdint.h>
+
+#ifndef BSP_REGMAP_SIZE
+#define BSP_REGMAP_SIZE 64
+#endif
+
+/**
+ * @brief Called (in interrupt context) for every byte the host writes to
+ * register `reg`.
+ */
+typedef void (*BspRegMapWriteCallback)(uint8_t reg, uint8_t value,
+                                       void* context);
+
+typedef struct {
+  uint8_t bank[2][BSP_REGMAP_SIZE];
+  // Bank served to the host.
+  volatile uint8_t front;
+  // Back bank committed, swap at the next transaction boundary.
+  volatile uint8_t pending;
+  // Host register pointer, auto-incremented.
+  volatile uint8_t pointer;
+  // The next byte written by the host is the register pointer.
+  volatile uint8_t pointer_phase;
+  BspRegMapWriteCallback on_write;
+  void* context;
+} BspRegMap;
+
+/**
+ * @brief Initialize an empty (all zero) register map.
+ *
+ * @param map
+ * @param on_write optional, may be NULL.
+ * @param context passed to `on_write`.
+ */
+void BspRegMapInit(BspRegMap* map, BspRegMapWriteCallback on_write,
+                   void* context);
+
+// ////////////////////////////////////////////////////////////////////////////
+// Application side
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Start a new frame. Withdraws a commit the host has not picked up yet
+ * and returns the back bank, initialized with the current front bank.
+ *
+ * @param map
+ * @return uint8_t* back bank of BSP_REGMAP_SIZE bytes.
+ */
+uint8_t* BspRegMapBegin(BspRegMap* map);
+
+/**
+ * @brief Publish the back bank. It is served from the next transaction
+ * boundary on.
+ *
+ * @param map
+ */
+void BspRegMapCommit(BspRegMap* map);
+
+// ////////////////////////////////////////////////////////////////////////////
+// Host side (called from the I2C interrupt)
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Address matched. For a write transaction the first byte is the
+ * register pointer.
+ *
+ * @param map
+ * @param read 1 if the host reads (target transmits).
+ */
+void BspRegMapHostStart(BspRegMap* map, uint8_t read);
+
+/**
+ * @brief Byte received from the host: register pointer or register data.
+ *
+ * @param map
+ * @param value
+ */
+void BspRegMapHostWrite(BspRegMap* map, uint8_t value);
+
+/**
+ * @brief Byte at the register pointer, to be preloaded into the transmit
+ * register. Does not advance the pointer.
+ *
+ * @param map
+ * @return uint8_t
+ */
+uint8_t BspRegMapHostReadFirst(BspRegMap* map);
+
+/**
+ * @brief The preloaded byte has been taken by the shift register. Advance the
+ * pointer and return the next byte to preload.
+ *
+ * @param map
+ * @return uint8_t
+ */
+uint8_t BspRegMapHostReadNext(BspRegMap* map);
+
+/**
+ * @brief STOP condition detected, end of transaction.
+ *
+ * @param map
+ */
+void BspRegMapHostStop(BspRegMap* map);
+
+#endif /* BSP_INCLUDE_REGMAP_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file spi_bus.h
+ * @author DFlubacher
+ * @brief SPI1 bus manager: shared bus, one chip select per device.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Tasks access SPI1 devices through transactions only. A transaction is a
+ * list of segments executed back to back with the chip select asserted, no
+ * other task gets onto the bus in between. Arbitration uses a FreeRTOS mutex,
+ * a high priority task waiting for the bus lifts the priority of the current
+ * owner (priority inheritance).
+ *
+ * Segments are moved by DMA, the calling task blocks on its task notification
+ * until the segment completes. Once the bus manager is used, the direct
+ * BspSPI1_xxx() functions (e.g. `BspSPI1_BMP390_Read()`) must not be called
+ * from tasks any more, they bypass the lock.
+ *
+ */
+
+#ifndef BSP_INCLUDE_SPI_BUS_H_
+#define BSP_INCLUDE_SPI_BUS_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "comms.h"
+
+/**
+ * @brief One span of a transaction, see `BspSPI1_TransferStart()` for NULL
+ * `tx` (RX-only) and NULL `rx` (TX-only).
+ */
+typedef struct {
+  const uint8_t* tx;
+  uint8_t* rx;
+  uint16_t length;
+} BspSpiSegment;
+
+/**
+ * @brief Initialize SPI1 (`BspSPI1_Init()`) and the bus lock. Call once,
+ * before any other function of the bus manager.
+ */
+void BspSpiBusInit(void);
+
+/**
+ * @brief Add `device` to the bus, its chip select is configured as output and
+ * deselected. The descriptor must stay valid (static or const).
+ *
+ * @param device
+ */
+void BspSpiBusRegister(const BspSpiDevice* device);
+
+/**
+ * @brief Execute `nsegments` segments on `device` with CS asserted throughout.
+ * With hardware CRC enabled for the device, every segment ends with its CRC.
+ * Task context only, with the scheduler running. The task notification
+ * (index 0) of the calling task is used to wait for DMA completion.
+ *
+ * @param device
+ * @param segments
+ * @param nsegments
+ * @param timeout ticks to wait for the bus and for each segment.
+ * @return uint8_t BSP_SPI_OK, BSP_SPI_ERR_BUSY (bus not obtained),
+ *         BSP_SPI_ERR_TIMEOUT (segment aborted) or BSP_SPI_ERR_DMA.
+ */
+uint8_t BspSpiBusTransact(const BspSpiDevice* device,
+                          const BspSpiSegment* segments, uint8_t nsegments,
+                          TickType_t timeout);
+
+/**
+ * @brief Command followed by a read, e.g. register address and data.
+ *
+ * @param device
+ * @param command
+ * @param command_length
+ * @param data
+ * @param length
+ * @param timeout
+ * @return uint8_t see `BspSpiBusTransact()`.
+ */
+uint8_t BspSpiBusRead(const BspSpiDevice* device, const uint8_t* command,
+                      uint16_t command_length, uint8_t* data, uint16_t length,
+                      TickType_t timeout);
+
+/**
+ * @brief Command followed by a write, e.g. register address and data.
+ *
+ * @param device
+ * @param command
+ * @param command_length
+ * @param data
+ * @param length
+ * @param timeout
+ * @return uint8_t see `BspSpiBusTransact()`.
+ */
+uint8_t BspSpiBusWrite(const BspSpiDevice* device, const uint8_t* command,
+                       uint16_t command_length, const uint8_t* data,
+                       uint16_t length, TickType_t timeout);
+
+#endif /* BSP_INCLUDE_SPI_BUS_H_ */
@@ -0,0 +1,110 @@
+/**
+ * @file spi_flash.h
+ * @author DFlubacher
+ * @brief SPI NOR flash (W25Qxx, MX25Lxx, ...) on the SPI1 bus.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * 3-byte addressing (up to 16 MB), 256 byte pages, 4 KB sectors. Program and
+ * erase only start the operation, `BspSpiFlashBusy()` polls the WIP bit of the
+ * status register. FreeRTOS task context (uses the SPI bus manager).
+ *
+ */
+
+#ifndef BSP_INCLUDE_SPI_FLASH_H_
+#define BSP_INCLUDE_SPI_FLASH_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "comms.h"
+#include "log_store.h"
+
+/**
+ * @brief Return codes.
+ * - BSP_FLASH_ERR_BUS: SPI bus transaction failed.
+ * - BSP_FLASH_ERR_ID: no (supported) flash answered the JEDEC ID command.
+ * - BSP_FLASH_ERR_TIMEOUT: still busy after the timeout.
+ */
+#define BSP_FLASH_OK 0
+#define BSP_FLASH_ERR_BUS 1
+#define BSP_FLASH_ERR_ID 2
+#define BSP_FLASH_ERR_TIMEOUT 3
+
+#define BSP_FLASH_PAGE_SIZE 256
+#define BSP_FLASH_SECTOR_SIZE 4096
+
+/**
+ * @brief JEDEC ID, e.g. 0xEF 0x40 0x15 for a W25Q16 (2^0x15 = 2 MB).
+ */
+typedef struct {
+  uint8_t manufacturer;
+  uint8_t memory_type;
+  uint8_t capacity;
+  uint32_t size;
+} BspSpiFlashId;
+
+/**
+ * @brief Register `device` on the SPI bus and read the JEDEC ID.
+ *
+ * @param device e.g. mode 0, 24 MHz.
+ * @param id may be NULL.
+ * @return uint8_t BSP_FLASH_OK or BSP_FLASH_ERR_xxx.
+ */
+uint8_t BspSpiFlashInit(const BspSpiDevice* device, BspSpiFlashId* id);
+
+/**
+ * @brief Fast read (0x0B) of `length` bytes from `address`.
+ *
+ * @param address
+ * @param data
+ * @param length
+ * @return uint8_t BSP_FLASH_OK or BSP_FLASH_ERR_BUS.
+ */
+uint8_t BspSpiFlashRead(uint32_t address, uint8_t* data, uint32_t length);
+
+/**
+ * @brief Start a page program (write enable, 0x02). `length` bytes must not
+ * cross a page boundary, the target must be erased.
+ *
+ * @param address
+ * @param data
+ * @param length
+ * @return uint8_t BSP_FLASH_OK or BSP_FLASH_ERR_BUS.
+ */
+uint8_t BspSpiFlashProgram(uint32_t address, const uint8_t* data,
+                           uint16_t length);
+
+/**
+ * @brief Start a 4 KB sector erase (write enable, 0x20).
+ *
+ * @param address any address within the sector.
+ * @return uint8_t BSP_FLASH_OK or BSP_FLASH_ERR_BUS.
+ */
+uint8_t BspSpiFlashEraseSector(uint32_t address);
+
+/**
+ * @brief
+ * @return uint8_t 1 while a program or erase is in progress (or the status
+ *         could not be read), 0 if ready.
+ */
+uint8_t BspSpiFlashBusy(void);
+
+/**
+ * @brief Wait for the end of a program or erase, sleeping 1 tick between
+ * status reads.
+ *
+ * @param timeout ticks.
+ * @return uint8_t BSP_FLASH_OK or BSP_FLASH_ERR_TIMEOUT.
+ */
+uint8_t BspSpiFlashWait(TickType_t timeout);
+
+/**
+ * @brief The flash as backend of a log store (`BspLogMount()`), valid after
+ * `BspSpiFlashInit()`.
+ *
+ * @return const BspLogFlash*
+ */
+const BspLogFlash* BspSpiFlashLog(void);
+
+#endif /* BSP_INCLUDE_SPI_FLASH_H_ */
@@ -0,0 +1,155 @@
+/**
+ * @file timer_wheel.h
+ * @author DFlubacher
+ * @brief Hierarchical timer wheel: O(1) arm and cancel for many timeouts.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Four levels of 64 slots, level n holds timers due in less than 64^(n+1)
+ * ticks; a slot of level n > 0 is moved down (cascaded) when its time range
+ * starts. Timers further out than 64^4 ticks are parked in the last level
+ * and re-sorted when it comes around. Arming links a timer into a slot,
+ * cancelling unlinks it, no search in either case. Timeouts that are mostly
+ * cancelled before they fire (protocol requests) never get cascaded.
+ *
+ * The wheel is advanced by the owner: from a task every tick, from the tick
+ * hook or from a timer interrupt. Callbacks run there. Arm and cancel from
+ * another context need a lock (`BspTimerWheelSetLock()`) that is valid in
+ * all of them. When advancing from the tick hook or an interrupt, mask
+ * interrupts through BASEPRI, e.g.
+ *
+ *   static uint32_t WheelLock(void) {
+ *     return portSET_INTERRUPT_MASK_FROM_ISR();
+ *   }
+ *   static void WheelUnlock(uint32_t state) {
+ *     portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+ *   }
+ *
+ *   BspTimerWheelSetLock(&wheel, WheelLock, WheelUnlock);
+ *
+ * It saves and restores BASEPRI and is also valid in tasks. Not
+ * taskENTER_CRITICAL(), which asserts when called from an interrupt.
+ * No hardware access, host compilable.
+ *
+ */
+
+#ifndef BSP_INCLUDE_TIMER_WHEEL_H_
+#define BSP_INCLUDE_TIMER_WHEEL_H_
+
+#include <stdint.h>
+
+#define BSP_WHEEL_BITS 6
+#define BSP_WHEEL_SLOTS (1U << BSP_WHEEL_BITS)
+#define BSP_WHEEL_LEVELS 4
+
+// Longest timeout sorted exactly, longer ones are re-sorted on the way.
+#define BSP_WHEEL_RANGE (1UL << (BSP_WHEEL_BITS * BSP_WHEEL_LEVELS))
+
+typedef struct BspWheelTimer BspWheelTimer;
+
+/**
+ * @brief Lock against the other contexts using the wheel, returns the state
+ * to restore (e.g. the previous interrupt mask).
+ */
+typedef uint32_t (*BspWheelLock)(void);
+typedef void (*BspWheelUnlock)(uint32_t state);
+
+typedef void (*BspWheelCallback)(BspWheelTimer* timer, void* context);
+
+/**
+ * @brief Timer, owned by the caller (e.g. part of a request). Initialize with
+ * `BspWheelTimerInit()`.
+ */
+struct BspWheelTimer {
+  BspWheelTimer* next;
+  // Link pointing to this timer, NULL if not armed.
+  BspWheelTimer** pprev;
+  uint32_t expires;
+  BspWheelCallback callback;
+  void* context;
+};
+
+typedef struct {
+  // Timers armed.
+  uint32_t armed;
+  // Timers cancelled while armed.
+  uint32_t cancelled;
+  uint32_t fired;
+  // Timers moved down a level.
+  uint32_t cascaded;
+} BspWheelStats;
+
+typedef struct {
+  // Last tick processed.
+  uint32_t now;
+  BspWheelTimer* slots[BSP_WHEEL_LEVELS][BSP_WHEEL_SLOTS];
+  BspWheelStats stats;
+  // NULL: all calls from one context.
+  BspWheelLock lock;
+  BspWheelUnlock unlock;
+} BspTimerWheel;
+
+/**
+ * @brief Empty wheel starting at tick `now`, without a lock.
+ *
+ * @param wheel
+ * @param now
+ */
+void BspTimerWheelInit(BspTimerWheel* wheel, uint32_t now);
+
+/**
+ * @brief Lock taken by advance, arm and cancel, released around callbacks.
+ * Set before the wheel is shared.
+ *
+ * @param wheel
+ * @param lock NULL for none.
+ * @param unlock
+ */
+void BspTimerWheelSetLock(BspTimerWheel* wheel, BspWheelLock lock,
+                          BspWheelUnlock unlock);
+
+/**
+ * @brief Process all ticks up to and including `now` and call the callbacks
+ * of the timers due. Callbacks may arm and cancel timers.
+ *
+ * @param wheel
+ * @param now e.g. xTaskGetTickCount().
+ */
+void BspTimerWheelAdvance(BspTimerWheel* wheel, uint32_t now);
+
+/**
+ * @brief
+ *
+ * @param timer
+ * @param callback
+ * @param context
+ */
+void BspWheelTimerInit(BspWheelTimer* timer, BspWheelCallback callback,
+                       void* context);
+
+/**
+ * @brief Arm (or re-arm) `timer` to fire `ticks` after the last processed
+ * tick, O(1).
+ *
+ * @param wheel
+ * @param timer
+ * @param ticks at least 1.
+ */
+void BspWheelTimerArm(BspTimerWheel* wheel, BspWheelTimer* timer,
+                      uint32_t ticks);
+
+/**
+ * @brief Cancel `timer` if armed, O(1).
+ *
+ * @param wheel
+ * @param timer
+ */
+void BspWheelTimerCancel(BspTimerWheel* wheel, BspWheelTimer* timer);
+
+/**
+ * @brief
+ * @return uint8_t 1 if `timer` is armed.
+ */
+uint8_t BspWheelTimerActive(const BspWheelTimer* timer);
+
+#endif /* BSP_INCLUDE_TIMER_WHEEL_H_ */
@@ -0,0 +1,180 @@
+/**
+ * @file ubx.h
+ * @author DFlubacher
+ * @brief Incremental u-blox UBX protocol parser working in place.
+ * @version 0.1
+ * @date 2026-10-19
+ * References:
+ * - u-blox M9 SPG 4.04 Interface Description, UBX-21022436.
+ *
+ * The parser scans a receive ring buffer (e.g. filled by SPI DMA) between its
+ * read index and the producer's write index. It skips the 0xFF idle filler of
+ * the SPI interface, computes the checksum on the fly and dispatches complete,
+ * valid frames by class/ID. Payloads are not copied: a message refers to the
+ * ring, split into at most two parts where the ring wraps. The accessors
+ * `BspUbxU8()` ... hide the split.
+ *
+ * Messages are only valid during the handler call. The producer must not
+ * overwrite the frame in progress, see `BspUbxTail()`. No hardware access,
+ * the parser can be compiled and exercised on a host.
+ *
+ */
+
+#ifndef BSP_INCLUDE_UBX_H_
+#define BSP_INCLUDE_UBX_H_
+
+#include <stdint.h>
+
+#define BSP_UBX_CLASS_NAV 0x01
+#define BSP_UBX_CLASS_ACK 0x05
+#define BSP_UBX_ID_NAV_PVT 0x07
+#define BSP_UBX_ID_NAV_SAT 0x35
+#define BSP_UBX_ID_ACK_ACK 0x01
+#define BSP_UBX_ID_ACK_NAK 0x00
+
+#define BSP_UBX_NAV_PVT_LENGTH 92
+
+/**
+ * @brief Valid frame, payload in place: `part[0]` with `part_length[0]`
+ * bytes, followed by `part[1]` (ring wrap, `part_length[1]` may be 0).
+ */
+typedef struct {
+  uint8_t msg_class;
+  uint8_t msg_id;
+  uint16_t length;
+  const uint8_t* part[2];
+  uint16_t part_length[2];
+} BspUbxMessage;
+
+typedef void (*BspUbxHandler)(const BspUbxMessage* message, void* context);
+
+/**
+ * @brief Dispatch table entry. The first entry matching class and ID is
+ * called.
+ */
+typedef struct {
+  uint8_t msg_class;
+  uint8_t msg_id;
+  BspUbxHandler handler;
+  void* context;
+} BspUbxRoute;
+
+typedef struct {
+  // Valid frames, dispatched or not.
+  uint32_t frames;
+  // Valid frames without a route.
+  uint32_t unhandled;
+  uint32_t checksum_errors;
+  // Frames not fitting into the ring.
+  uint32_t length_errors;
+  // Filler and garbage between frames.
+  uint32_t skipped;
+} BspUbxStats;
+
+typedef struct {
+  const uint8_t* ring;
+  uint16_t size;
+  const BspUbxRoute* routes;
+  uint8_t nroutes;
+  // Next byte to parse.
+  uint16_t read;
+  // First byte of the frame in progress.
+  uint16_t start;
+  // Frame in progress.
+  uint8_t state;
+  uint8_t ck_a;
+  uint8_t ck_b;
+  uint8_t msg_class;
+  uint8_t msg_id;
+  uint16_t length;
+  uint16_t count;
+  uint16_t payload;
+  BspUbxStats stats;
+} BspUbxParser;
+
+/**
+ * @brief Subset of UBX-NAV-PVT, units as in the message.
+ */
+typedef struct {
+  // GPS time of week, ms.
+  uint32_t itow;
+  uint16_t year;
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;
+  uint8_t min;
+  uint8_t sec;
+  uint8_t valid;
+  // 0: no fix, 2: 2D, 3: 3D, ...
+  uint8_t fix_type;
+  uint8_t flags;
+  uint8_t num_sv;
+  // 1e-7 deg.
+  int32_t lon;
+  int32_t lat;
+  // mm.
+  int32_t height;
+  int32_t h_msl;
+  uint32_t h_acc;
+  uint32_t v_acc;
+  // mm/s.
+  int32_t vel_n;
+  int32_t vel_e;
+  int32_t vel_d;
+  int32_t g_speed;
+  // 1e-5 deg.
+  int32_t head_mot;
+  // 0.01.
+  uint16_t p_dop;
+} BspUbxNavPvt;
+
+/**
+ * @brief Initialize `parser` for the ring buffer `ring` of `size` bytes.
+ * Frames longer than `size` - 8 bytes are dropped.
+ *
+ * @param parser
+ * @param ring
+ * @param size
+ * @param routes
+ * @param nroutes
+ */
+void BspUbxInit(BspUbxParser* parser, const uint8_t* ring, uint16_t size,
+                const BspUbxRoute* routes, uint8_t nroutes);
+
+/**
+ * @brief Parse the new bytes up to (excluding) `write`, the producer's ring
+ * index. Handlers are called from here.
+ *
+ * @param parser
+ * @param write
+ */
+void BspUbxParse(BspUbxParser* parser, uint16_t write);
+
+/**
+ * @brief Oldest ring index still needed by the parser (start of the frame in
+ * progress). The producer may fill the ring up to the byte before it.
+ *
+ * @param parser
+ * @return uint16_t
+ */
+uint16_t BspUbxTail(const BspUbxParser* parser);
+
+/**
+ * @brief Payload accessors, little-endian, `offset` into the payload.
+ */
+uint8_t BspUbxU8(const BspUbxMessage* message, uint16_t offset);
+
+uint16_t BspUbxU16(const BspUbxMessage* message, uint16_t offset);
+
+uint32_t BspUbxU32(const BspUbxMessage* message, uint16_t offset);
+
+/**
+ * @brief Decode a NAV-PVT message.
+ *
+ * @param message
+ * @param pvt
+ * @return uint8_t 0 if ok, 1 if `message` is no (complete) NAV-PVT.
+ */
+uint8_t BspUbxNavPvtDecode(const BspUbxMessage* message, BspUbxNavPvt* pvt);
+
+#endif /* BSP_INCLUDE_UBX_H_ */
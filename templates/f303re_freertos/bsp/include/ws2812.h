@@ -0,0 +1,73 @@
+/**
+ * @file ws2812.h
+ * @author DFlubacher
+ * @brief WS2812-style LED chain on TIM8_CH1, bits streamed by DMA.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * TIM8 runs at 48 MHz with a period of 60 clocks (1.25 us, 800 kbit/s). Each
+ * update event requests a DMA burst (DCR/DMAR) that writes the next compare
+ * value (high time of the next bit) into CCR1, DMA2 channel 1. The CPU only
+ * renders frames into a slot buffer with a nibble lookup table (no per-bit
+ * work) and is interrupted once per frame.
+ *
+ * Two frame buffers: while one goes out, the next is rendered into the
+ * other. A frame ends with a low reset period that latches the colours.
+ *
+ * Pin PA15 (AF2, TIM8_CH1, CN7-17). Uses TIM8 exclusively (not together with
+ * `BspTimer8PwmInit()`).
+ *
+ */
+
+#ifndef BSP_INCLUDE_WS2812_H_
+#define BSP_INCLUDE_WS2812_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Return codes.
+ * - BSP_WS2812_ERR_BUSY: both buffers in use (one going out, one queued).
+ */
+#define BSP_WS2812_OK 0
+#define BSP_WS2812_ERR_BUSY 1
+
+// LEDs in the chain.
+#ifndef BSP_WS2812_LEDS
+#define BSP_WS2812_LEDS 60
+#endif
+
+// Low bit slots after a frame, 240 x 1.25 us = 300 us (newer parts latch
+// after 280 us).
+#ifndef BSP_WS2812_RESET_SLOTS
+#define BSP_WS2812_RESET_SLOTS 240
+#endif
+
+/**
+ * @brief Configure PA15, TIM8 and DMA2 channel 1, output low.
+ */
+void BspWs2812Init(void);
+
+/**
+ * @brief Render colours into the free buffer, it is sent by `BspWs2812Show()`.
+ *
+ * @param colors 0x00RRGGBB, sent in the chain's GRB order.
+ * @param count up to BSP_WS2812_LEDS, the remaining LEDs are turned off.
+ * @return uint8_t BSP_WS2812_OK or BSP_WS2812_ERR_BUSY.
+ */
+uint8_t BspWs2812Render(const uint32_t* colors, uint16_t count);
+
+/**
+ * @brief Send the rendered frame: now if the chain is idle, else right
+ * after the frame going out.
+ *
+ * @return uint8_t BSP_WS2812_OK or BSP_WS2812_ERR_BUSY (a frame is queued).
+ */
+uint8_t BspWs2812Show(void);
+
+/**
+ * @brief
+ * @return uint8_t 1 while a frame is going out or queued.
+ */
+uint8_t BspWs2812Busy(void);
+
+#endif /* BSP_INCLUDE_WS2812_H_ */
@@ -0,0 +1,273 @@
+/**
+ * @file log_store.c
+ * @author DFlubacher
+ * @brief Append-only record store on NOR flash.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "log_store.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_MAGIC 0x4C47
+
+// The producer and the service hand page buffers over through the free
+// running counters `sealed` and `programmed`. Release/acquire ordering makes
+// the buffer contents visible before the counter.
+#define LOG_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_ACQUIRE)
+#define LOG_STORE(counter, value) \
+  __atomic_store_n(&(counter), (value), __ATOMIC_RELEASE)
+
+static uint16_t LogU16(const uint8_t* data) {
+  return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static uint32_t LogU32(const uint8_t* data) {
+  return (uint32_t)LogU16(data) | ((uint32_t)LogU16(&data[2]) << 16);
+}
+
+static void LogPut16(uint8_t* data, uint16_t value) {
+  data[0] = (uint8_t)value;
+  data[1] = (uint8_t)(value >> 8);
+}
+
+static void LogPut32(uint8_t* data, uint32_t value) {
+  LogPut16(data, (uint16_t)value);
+  LogPut16(&data[2], (uint16_t)(value >> 16));
+}
+
+/**
+ * @brief Producer: close the page buffer being filled and pass it on.
+ *
+ * @param store
+ */
+static void LogSeal(BspLogStore* store) {
+  uint32_t sealed = store->sealed;
+  uint8_t* page = store->buffers[sealed % BSP_LOG_BUFFERS];
+
+  // The sequence number is set when the page is programmed.
+  LogPut16(&page[0], LOG_MAGIC);
+  LogPut16(&page[2], store->fill);
+  memset(&page[store->fill], 0xFF, BSP_LOG_PAGE_SIZE - store->fill);
+
+  store->fill = 0;
+  LOG_STORE(store->sealed, sealed + 1);
+}
+
+/**
+ * @brief Service: erase the sector at the end of the erased region. If the
+ * ring has wrapped, it holds the oldest pages.
+ *
+ * @param store
+ * @return uint8_t 0 if the erase started.
+ */
+static uint8_t LogErase(BspLogStore* store) {
+  const BspLogFlash* flash = store->flash;
+  uint32_t address = (store->head + store->erased) % flash->size;
+  uint32_t lost;
+
+  if ((store->pages > 0) && (store->tail >= address) &&
+      (store->tail < (address + flash->sector_size))) {
+    lost = (address + flash->sector_size - store->tail) / BSP_LOG_PAGE_SIZE;
+    if (lost > store->pages) lost = store->pages;
+    store->pages -= lost;
+    store->stats.pages_overwritten += lost;
+    store->tail = (store->pages > 0)
+                      ? (address + flash->sector_size) % flash->size
+                      : store->head;
+  }
+
+  if (flash->erase(flash->context, address) != 0) {
+    ++store->stats.flash_errors;
+    return 1;
+  }
+  store->erased += flash->sector_size;
+  ++store->stats.sectors_erased;
+  return 0;
+}
+
+/**
+ * @brief Service: program the oldest sealed page buffer at the head and
+ * release the buffer. `program` has taken the data when it returns.
+ *
+ * @param store
+ * @return uint8_t 0 if programming started.
+ */
+static uint8_t LogProgram(BspLogStore* store) {
+  const BspLogFlash* flash = store->flash;
+  uint32_t programmed = store->programmed;
+  uint8_t* page = store->buffers[programmed % BSP_LOG_BUFFERS];
+
+  LogPut32(&page[4], store->sequence);
+  if (flash->program(flash->context, store->head, page, BSP_LOG_PAGE_SIZE) !=
+      0) {
+    ++store->stats.flash_errors;
+    return 1;
+  }
+
+  if (store->pages++ == 0) store->tail = store->head;
+  ++store->sequence;
+  store->head = (store->head + BSP_LOG_PAGE_SIZE) % flash->size;
+  store->erased -= BSP_LOG_PAGE_SIZE;
+  ++store->stats.pages_programmed;
+
+  LOG_STORE(store->programmed, programmed + 1);
+  return 0;
+}
+
+uint8_t BspLogMount(BspLogStore* store, const BspLogFlash* flash) {
+  uint8_t header[BSP_LOG_HEADER_SIZE];
+  uint32_t address;
+  uint32_t sequence;
+  uint32_t newest = 0;
+  uint32_t oldest = 0;
+  uint32_t newest_address = 0;
+  uint32_t oldest_address = 0;
+  uint32_t offset;
+
+  memset(store, 0, sizeof(*store));
+  store->flash = flash;
+
+  for (address = 0; address < flash->size; address += BSP_LOG_PAGE_SIZE) {
+    if (flash->read(flash->context, address, header, sizeof(header)) != 0) {
+      return BSP_LOG_ERR_FLASH;
+    }
+    if (LogU16(&header[0]) != LOG_MAGIC) continue;
+
+    sequence = LogU32(&header[4]);
+    if ((store->pages == 0) || (sequence > newest)) {
+      newest = sequence;
+      newest_address = address;
+    }
+    if ((store->pages == 0) || (sequence < oldest)) {
+      oldest = sequence;
+      oldest_address = address;
+    }
+    ++store->pages;
+  }
+
+  if (store->pages > 0) {
+    store->head = (newest_address + BSP_LOG_PAGE_SIZE) % flash->size;
+    store->tail = oldest_address;
+    store->sequence = newest + 1;
+  }
+
+  // Pages are programmed in order, the rest of the head's sector is erased.
+  // At a sector start the sector must be erased first.
+  offset = store->head % flash->sector_size;
+  store->erased = (offset != 0) ? (flash->sector_size - offset) : 0;
+
+  return BSP_LOG_OK;
+}
+
+uint8_t BspLogAppend(BspLogStore* store, const void* data, uint16_t length) {
+  uint32_t in_use;
+  uint8_t* page;
+
+  if (length > BSP_LOG_RECORD_MAX) return BSP_LOG_ERR_SIZE;
+
+  if ((store->fill + 2U + length) > BSP_LOG_PAGE_SIZE) LogSeal(store);
+
+  if (store->fill == 0) {
+    in_use = store->sealed - LOG_LOAD(store->programmed);
+    if (in_use >= BSP_LOG_BUFFERS) {
+      ++store->stats.dropped;
+      return BSP_LOG_ERR_FULL;
+    }
+    if ((in_use + 1) > store->stats.buffers_peak) {
+      store->stats.buffers_peak = in_use + 1;
+    }
+    store->fill = BSP_LOG_HEADER_SIZE;
+  }
+
+  page = store->buffers[store->sealed % BSP_LOG_BUFFERS];
+  LogPut16(&page[store->fill], length);
+  memcpy(&page[store->fill + 2], data, length);
+  store->fill += 2 + length;
+  ++store->stats.records;
+
+  return BSP_LOG_OK;
+}
+
+void BspLogFlush(BspLogStore* store) {
+  if (store->fill > BSP_LOG_HEADER_SIZE) LogSeal(store);
+}
+
+uint8_t BspLogService(BspLogStore* store) {
+  const BspLogFlash* flash = store->flash;
+  uint32_t ahead = BSP_LOG_ERASE_AHEAD * flash->sector_size;
+
+  while (flash->busy(flash->context) == 0) {
+    // The head must never run into unerased flash.
+    if (store->erased == 0) {
+      if (LogErase(store) != 0) break;
+    } else if (store->programmed != LOG_LOAD(store->sealed)) {
+      if (LogProgram(store) != 0) break;
+    } else if (store->erased < ahead) {
+      if (LogErase(store) != 0) break;
+    } else {
+      break;
+    }
+  }
+
+  return (uint8_t)(LOG_LOAD(store->sealed) - store->programmed);
+}
+
+void BspLogReadBegin(const BspLogStore* store, BspLogCursor* cursor) {
+  cursor->address = store->tail;
+  cursor->pages = store->pages;
+  cursor->offset = 0;
+  cursor->used = 0;
+}
+
+uint8_t BspLogReadNext(const BspLogStore* store, BspLogCursor* cursor,
+                       uint8_t* data, uint16_t max, uint16_t* length) {
+  const BspLogFlash* flash = store->flash;
+  uint8_t header[BSP_LOG_HEADER_SIZE];
+  uint16_t record;
+
+  while (cursor->pages > 0) {
+    // ===   Enter a page: header   ============================================
+    if (cursor->offset == 0) {
+      if (flash->read(flash->context, cursor->address, header,
+                      sizeof(header)) != 0) {
+        return BSP_LOG_ERR_FLASH;
+      }
+      cursor->used = LogU16(&header[2]);
+      // A damaged page is skipped.
+      if ((LogU16(&header[0]) != LOG_MAGIC) ||
+          (cursor->used > BSP_LOG_PAGE_SIZE)) {
+        cursor->used = 0;
+      }
+      cursor->offset = BSP_LOG_HEADER_SIZE;
+    }
+
+    // ===   Next record of the page   =========================================
+    if ((cursor->offset + 2U) <= cursor->used) {
+      if (flash->read(flash->context, cursor->address + cursor->offset, header,
+                      2) != 0) {
+        return BSP_LOG_ERR_FLASH;
+      }
+      record = LogU16(header);
+      if ((cursor->offset + 2U + record) <= cursor->used) {
+        if (flash->read(flash->context, cursor->address + cursor->offset + 2,
+                        data, (record < max) ? record : max) != 0) {
+          return BSP_LOG_ERR_FLASH;
+        }
+        cursor->offset += 2 + record;
+        *length = record;
+        return BSP_LOG_OK;
+      }
+    }
+
+    // ===   Page done   =======================================================
+    cursor->address = (cursor->address + BSP_LOG_PAGE_SIZE) % flash->size;
+    cursor->offset = 0;
+    --cursor->pages;
+  }
+
+  return BSP_LOG_END;
+}
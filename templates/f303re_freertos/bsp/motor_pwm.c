@@ -0,0 +1,336 @@
+/**
+ * @file motor_pwm.c
+ * @author DFlubacher
+ * @brief Three-phase motor PWM with midpoint ADC sampling.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "motor_pwm.h"
+
+#include <stdint.h>
+
+#include "delay.h"
+#include "stm32f3xx.h"
+
+// ADC1/2 injected trigger JEXT10: TIM8_TRGO2 (RM0316 15.3.18).
+#define MOTOR_PWM_JEXTSEL 10
+
+// ADC sample time code 0b011: 7.5 ADC clocks, 417 ns per channel at 48 MHz.
+#define MOTOR_PWM_SMP 0x03
+
+// Break input filter: 8 samples at 48 MHz.
+#define MOTOR_PWM_BKF 0x03
+
+#define MOTOR_PWM_TIMEOUT 1000000
+
+static uint16_t motor_pwm_period;
+static uint8_t motor_pwm_nchannels;
+static BspMotorPwmControl motor_pwm_control;
+static void* motor_pwm_context;
+
+static uint16_t motor_pwm_samples[4];
+static BspMotorPwmStats motor_pwm_stats;
+
+/**
+ * @brief Alternate function `af` on pin `pin` of `port`.
+ */
+static void MotorPwmPin(GPIO_TypeDef* port, uint8_t pin, uint8_t af) {
+  uint32_t shift = 4 * (pin % 8);
+
+  port->MODER &= ~(0x03UL << (2 * pin));
+  port->MODER |= (0x02UL << (2 * pin));
+  port->AFR[pin / 8] &= ~(0x0FUL << shift);
+  port->AFR[pin / 8] |= ((uint32_t)af << shift);
+}
+
+/**
+ * @brief Analog mode for the ADC1 inputs with a fixed pin.
+ */
+static void MotorPwmAnalogPin(uint8_t channel) {
+  if ((channel >= 1) && (channel <= 4)) {
+    GPIOA->MODER |= (0x03UL << (2 * (channel - 1)));
+  } else if ((channel >= 6) && (channel <= 9)) {
+    GPIOC->MODER |= (0x03UL << (2 * (channel - 6)));
+  }
+}
+
+/**
+ * @brief Dead-time generator setting (BDTR.DTG) for at least `dead_time_ns`.
+ * Steps of 1, 2, 8 and 16 timer clocks, see RM0316 TIMx_BDTR.
+ *
+ * @param dead_time_ns
+ * @param dtg
+ * @return uint8_t 0 if ok, 1 if longer than 1008 clocks.
+ */
+static uint8_t MotorPwmDeadTime(uint32_t dead_time_ns, uint8_t* dtg) {
+  // Timer clocks, rounded up.
+  uint32_t clocks = (uint32_t)(((uint64_t)dead_time_ns *
+                                    BSP_MOTOR_PWM_CLOCK_HZ +
+                                999999999U) /
+                               1000000000U);
+
+  if (clocks <= 127) {
+    *dtg = (uint8_t)clocks;
+  } else if (clocks <= 254) {
+    *dtg = (uint8_t)(0x80 | ((clocks + 1) / 2 - 64));
+  } else if (clocks <= 504) {
+    *dtg = (uint8_t)(0xC0 | ((clocks + 7) / 8 - 32));
+  } else if (clocks <= 1008) {
+    *dtg = (uint8_t)(0xE0 | ((clocks + 15) / 16 - 32));
+  } else {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Timer clocks since the last ADC trigger, from the counter position
+ * and direction. The trigger is BSP_MOTOR_PWM_SAMPLE_LEAD clocks before the
+ * peak, the duty update deadline ARR clocks after the peak (valley).
+ */
+static uint32_t MotorPwmElapsed(void) {
+  uint32_t down = TIM8->CR1 & TIM_CR1_DIR;
+  uint32_t count = TIM8->CNT;
+  uint32_t trigger = motor_pwm_period - BSP_MOTOR_PWM_SAMPLE_LEAD;
+
+  if (down) return BSP_MOTOR_PWM_SAMPLE_LEAD + motor_pwm_period - count;
+  if (count >= trigger) return count - trigger;
+  // Counting up again, past the valley.
+  return BSP_MOTOR_PWM_SAMPLE_LEAD + motor_pwm_period + count;
+}
+
+/**
+ * @brief Power up, calibrate and enable ADC1, injected sequence triggered by
+ * TRGO2.
+ *
+ * @param channels
+ * @param nchannels
+ * @return uint8_t BSP_MOTOR_PWM_OK or BSP_MOTOR_PWM_ERR_ADC.
+ */
+static uint8_t MotorPwmAdcInit(const uint8_t* channels, uint8_t nchannels) {
+  uint32_t timeout;
+  uint32_t jsqr;
+  uint8_t i;
+
+  // Synchronous clock HCLK / 1 (AHB prescaler 1): a fixed delay from the
+  // trigger to the sampling, no resynchronization jitter.
+  RCC->AHBENR |= RCC_AHBENR_ADC12EN;
+  ADC12_COMMON->CCR = (0x01 << ADC_CCR_CKMODE_Pos);
+
+  // Voltage regulator: 0b10 (reset) -> 0b00 -> 0b01, 10 us start-up.
+  ADC1->CR = 0x00000000;
+  ADC1->CR = ADC_CR_ADVREGEN_0;
+  BspDelayUs(10);
+
+  // Single-ended calibration.
+  ADC1->CR |= ADC_CR_ADCAL;
+  timeout = MOTOR_PWM_TIMEOUT;
+  while (((ADC1->CR & ADC_CR_ADCAL) != 0) && (--timeout > 0)) {
+  }
+  if (timeout == 0) return BSP_MOTOR_PWM_ERR_ADC;
+
+  // ADEN needs 4 ADC clocks after the end of the calibration.
+  BspDelayUs(1);
+  ADC1->ISR = ADC_ISR_ADRDY;
+  ADC1->CR |= ADC_CR_ADEN;
+  timeout = MOTOR_PWM_TIMEOUT;
+  while (((ADC1->ISR & ADC_ISR_ADRDY) == 0) && (--timeout > 0)) {
+  }
+  if (timeout == 0) return BSP_MOTOR_PWM_ERR_ADC;
+
+  // Sample times, sequence and trigger (rising edge of TRGO2).
+  ADC1->SMPR1 = 0x00000000;
+  ADC1->SMPR2 = 0x00000000;
+  jsqr = ((uint32_t)(nchannels - 1) << ADC_JSQR_JL_Pos) |
+         ((uint32_t)MOTOR_PWM_JEXTSEL << ADC_JSQR_JEXTSEL_Pos) |
+         (0x01UL << ADC_JSQR_JEXTEN_Pos);
+  for (i = 0; i < nchannels; ++i) {
+    MotorPwmAnalogPin(channels[i]);
+    if (channels[i] < 10) {
+      ADC1->SMPR1 |= ((uint32_t)MOTOR_PWM_SMP << (3 * channels[i]));
+    } else {
+      ADC1->SMPR2 |= ((uint32_t)MOTOR_PWM_SMP << (3 * (channels[i] - 10)));
+    }
+    jsqr |= ((uint32_t)channels[i] << (ADC_JSQR_JSQ1_Pos + 6 * i));
+  }
+  ADC1->JSQR = jsqr;
+
+  // One interrupt per sequence, then wait for triggers.
+  ADC1->ISR = ADC_ISR_JEOC | ADC_ISR_JEOS;
+  ADC1->IER = ADC_IER_JEOSIE;
+  NVIC_SetPriority(ADC1_2_IRQn, BSP_MOTOR_PWM_PRIORITY);
+  NVIC_EnableIRQ(ADC1_2_IRQn);
+  ADC1->CR |= ADC_CR_JADSTART;
+
+  return BSP_MOTOR_PWM_OK;
+}
+
+uint8_t BspMotorPwmInit(const BspMotorPwmConfig* config) {
+  uint32_t period;
+  uint8_t dtg;
+  uint8_t i;
+
+  // 1. Check the configuration.
+  if ((config->frequency_hz == 0) || (config->nchannels < 1) ||
+      (config->nchannels > 4)) {
+    return BSP_MOTOR_PWM_ERR_RANGE;
+  }
+  // Center-aligned: one period is ARR clocks up and ARR clocks down.
+  period = BSP_MOTOR_PWM_CLOCK_HZ / (2 * config->frequency_hz);
+  if ((period < 100) || (period > 0xFFFF)) return BSP_MOTOR_PWM_ERR_RANGE;
+  if (MotorPwmDeadTime(config->dead_time_ns, &dtg) != 0) {
+    return BSP_MOTOR_PWM_ERR_RANGE;
+  }
+  for (i = 0; i < config->nchannels; ++i) {
+    if ((config->channels[i] < 1) || (config->channels[i] > 18)) {
+      return BSP_MOTOR_PWM_ERR_RANGE;
+    }
+  }
+
+  motor_pwm_period = (uint16_t)period;
+  motor_pwm_nchannels = config->nchannels;
+  motor_pwm_control = config->control;
+  motor_pwm_context = config->context;
+  motor_pwm_stats = (BspMotorPwmStats){0};
+
+  // 2. Configure the pins, BKIN with pull-up (fault is active low).
+  RCC->AHBENR |=
+      RCC_AHBENR_GPIOAEN | RCC_AHBENR_GPIOCEN | RCC_AHBENR_GPIODEN;
+  for (i = 0; i < 3; ++i) {
+    MotorPwmPin(GPIOC, 6 + i, 4);
+    MotorPwmPin(GPIOC, 10 + i, 4);
+  }
+  MotorPwmPin(GPIOD, 2, 4);
+  GPIOD->PUPDR &= ~GPIO_PUPDR_PUPDR2_Msk;
+  GPIOD->PUPDR |= (0x01 << GPIO_PUPDR_PUPDR2_Pos);
+
+  // 3. Configure timer 8, outputs off.
+  RCC->APB2ENR |= RCC_APB2ENR_TIM8EN;
+  TIM8->CR1 = 0x0000;
+  TIM8->DIER = 0x0000;
+  TIM8->CCER = 0x0000;
+  TIM8->BDTR = 0x0000;
+  TIM8->PSC = 0;
+  TIM8->RCR = 0;
+  TIM8->ARR = motor_pwm_period;
+
+  // CH1 ... CH3: PWM mode 1 (0b110), preloaded. Start at 50 %.
+  TIM8->CCMR1 = (0x06 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE |
+                (0x06 << TIM_CCMR1_OC2M_Pos) | TIM_CCMR1_OC2PE;
+  TIM8->CCMR2 = (0x06 << TIM_CCMR2_OC3M_Pos) | TIM_CCMR2_OC3PE;
+  TIM8->CCR1 = motor_pwm_period / 2;
+  TIM8->CCR2 = motor_pwm_period / 2;
+  TIM8->CCR3 = motor_pwm_period / 2;
+
+  // CH4, no output: PWM mode 2 (0b111), OC4REF rises LEAD clocks before the
+  // peak. TRGO2 = OC4REF (0b0111) triggers the ADC.
+  TIM8->CCMR2 |= (0x07 << TIM_CCMR2_OC4M_Pos) | TIM_CCMR2_OC4PE;
+  TIM8->CCR4 = motor_pwm_period - BSP_MOTOR_PWM_SAMPLE_LEAD;
+  TIM8->CR2 = (0x07 << TIM_CR2_MMS2_Pos);
+
+  // Both outputs of each phase enabled, active high, idle low.
+  TIM8->CCER = TIM_CCER_CC1E | TIM_CCER_CC1NE | TIM_CCER_CC2E |
+               TIM_CCER_CC2NE | TIM_CCER_CC3E | TIM_CCER_CC3NE;
+
+  // Dead-time, break on BKIN low (filtered), outputs driven inactive while
+  // MOE is off. MOE stays off until `BspMotorPwmEnable()`.
+  TIM8->BDTR = ((uint32_t)dtg << TIM_BDTR_DTG_Pos) | TIM_BDTR_OSSI |
+               TIM_BDTR_OSSR | TIM_BDTR_BKE |
+               (MOTOR_PWM_BKF << TIM_BDTR_BKF_Pos);
+
+  // Center-aligned mode 1 (0b01), auto-reload preloaded. Load the preloads.
+  TIM8->CR1 = (0x01 << TIM_CR1_CMS_Pos) | TIM_CR1_ARPE;
+  TIM8->EGR = TIM_EGR_UG;
+  TIM8->SR = 0;
+
+  TIM8->DIER = TIM_DIER_BIE;
+  NVIC_SetPriority(TIM8_BRK_IRQn, 6);
+  NVIC_EnableIRQ(TIM8_BRK_IRQn);
+
+  // 4. ADC, then start counting.
+  if (MotorPwmAdcInit(config->channels, config->nchannels) != 0) {
+    return BSP_MOTOR_PWM_ERR_ADC;
+  }
+  TIM8->CR1 |= TIM_CR1_CEN;
+
+  return BSP_MOTOR_PWM_OK;
+}
+
+uint16_t BspMotorPwmPeriod(void) { return motor_pwm_period; }
+
+void BspMotorPwmSetDuties(const uint16_t* duties) {
+  // The three compares switch at the same update, not across one.
+  TIM8->CR1 |= TIM_CR1_UDIS;
+  TIM8->CCR1 = duties[0];
+  TIM8->CCR2 = duties[1];
+  TIM8->CCR3 = duties[2];
+  TIM8->CR1 &= ~TIM_CR1_UDIS;
+}
+
+uint8_t BspMotorPwmEnable(void) {
+  // The break input is level sensitive, MOE can't be set while it is low.
+  if ((GPIOD->IDR & GPIO_IDR_2) == 0) return 1;
+
+  TIM8->SR = ~(uint32_t)TIM_SR_BIF;
+  TIM8->DIER |= TIM_DIER_BIE;
+  TIM8->BDTR |= TIM_BDTR_MOE;
+  return 0;
+}
+
+void BspMotorPwmDisable(void) { TIM8->BDTR &= ~TIM_BDTR_MOE; }
+
+void BspMotorPwmSamples(uint16_t* samples) {
+  uint32_t primask = __get_PRIMASK();
+  uint8_t i;
+
+  __disable_irq();
+  for (i = 0; i < motor_pwm_nchannels; ++i) samples[i] = motor_pwm_samples[i];
+  __set_PRIMASK(primask);
+}
+
+void BspMotorPwmGetStats(BspMotorPwmStats* stats) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *stats = motor_pwm_stats;
+  __set_PRIMASK(primask);
+}
+
+void ADC1_2_IRQHandler(void) {
+  uint32_t entry = MotorPwmElapsed();
+  uint32_t done;
+  uint8_t i;
+
+  if ((ADC1->ISR & ADC_ISR_JEOS) == 0) return;
+  ADC1->ISR = ADC_ISR_JEOC | ADC_ISR_JEOS;
+
+  // JDR1 ... JDR4 are consecutive.
+  for (i = 0; i < motor_pwm_nchannels; ++i) {
+    motor_pwm_samples[i] = (uint16_t)(&ADC1->JDR1)[i];
+  }
+  if (motor_pwm_control != 0) {
+    motor_pwm_control(motor_pwm_samples, motor_pwm_context);
+  }
+
+  // ===   Timing   ============================================================
+  done = MotorPwmElapsed();
+  ++motor_pwm_stats.cycles;
+  if (entry > motor_pwm_stats.entry_max) motor_pwm_stats.entry_max = entry;
+  motor_pwm_stats.done_last = done;
+  if (done > motor_pwm_stats.done_max) motor_pwm_stats.done_max = done;
+  if (done > (BSP_MOTOR_PWM_SAMPLE_LEAD + motor_pwm_period)) {
+    ++motor_pwm_stats.late;
+  }
+}
+
+void TIM8_BRK_IRQHandler(void) {
+  // The hardware has already cleared MOE. Off until the next enable, the
+  // flag would be set again while the input stays low.
+  if ((TIM8->SR & TIM_SR_BIF) != 0) {
+    TIM8->SR = ~(uint32_t)TIM_SR_BIF;
+    TIM8->DIER &= ~TIM_DIER_BIE;
+    ++motor_pwm_stats.breaks;
+  }
+}
@@ -0,0 +1,330 @@
+/**
+ * @file oc_sched.c
+ * @author DFlubacher
+ * @brief Output compare event scheduler.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "oc_sched.h"
+
+#include <stdint.h>
+
+#include "bsp_timers.h"
+#include "stm32f3xx.h"
+
+// Output compare modes beyond the pin actions (OCxM).
+#define OC_SCHED_FROZEN 0x00
+#define OC_SCHED_FORCE_LOW 0x04
+#define OC_SCHED_FORCE_HIGH 0x05
+
+// Cycles the reference may be off before it is taken anew, covers a tick
+// starting between reading the cycle counter and the timer.
+#define OC_SCHED_SYNC_SLACK 8U
+
+typedef struct OcSchedEvent {
+  struct OcSchedEvent* next;
+  uint32_t at;
+  uint8_t action;
+  BspOcSchedCallback callback;
+  void* context;
+} OcSchedEvent;
+
+typedef struct {
+  GPIO_TypeDef* port;
+  uint8_t pin;
+} OcSchedPin;
+
+// Pins of channels 2 and 3.
+static const OcSchedPin oc_sched_pins[2] = {{GPIOA, 1}, {GPIOB, 10}};
+
+static OcSchedEvent oc_sched_pool[BSP_OC_SCHED_EVENTS];
+static OcSchedEvent* oc_sched_free;
+// Sorted queues of channels 2 ... 4.
+static OcSchedEvent* oc_sched_queues[3];
+// Bit per channel: its queue is being worked on, don't arm from
+// `BspOcSchedAdd()`.
+static uint8_t oc_sched_busy;
+
+// A timebase tick and the cycle count at its start. Counter and core run
+// from the same clock, every later tick starts a multiple of
+// `oc_sched_cycles_per_tick` cycles after it.
+static uint32_t oc_sched_tick_ref;
+static uint32_t oc_sched_cycles_ref;
+static uint32_t oc_sched_cycles_per_tick;
+
+static BspOcSchedStats oc_sched_stats;
+
+static void OcSchedFired(uint8_t channel);
+
+static void OcSchedFired2(void) { OcSchedFired(2); }
+
+static void OcSchedFired3(void) { OcSchedFired(3); }
+
+static void OcSchedFired4(void) { OcSchedFired(4); }
+
+static const BspTimeCallback oc_sched_handlers[3] = {
+    OcSchedFired2, OcSchedFired3, OcSchedFired4};
+
+/**
+ * @brief Output compare mode of `channel` (OCxM, CCMR1/CCMR2).
+ */
+static void OcSchedMode(uint8_t channel, uint8_t mode) {
+  volatile uint32_t* ccmr = (channel <= 2) ? &TIM2->CCMR1 : &TIM2->CCMR2;
+  uint32_t shift = ((channel % 2) == 0) ? 12 : 4;
+
+  *ccmr = (*ccmr & ~(0x07UL << shift)) | ((uint32_t)mode << shift);
+}
+
+/**
+ * @brief Relate the cycle counter to the timebase at the start of the next
+ * tick (waits up to 1 us). Interrupts disabled.
+ */
+static void OcSchedAnchor(void) {
+  uint32_t count = TIM2->CNT;
+
+  while (TIM2->CNT == count) {
+  }
+  oc_sched_cycles_ref = DWT->CYCCNT;
+  oc_sched_tick_ref = count + 1;
+}
+
+/**
+ * @brief The reference still holds: the cycles since it, less whole ticks,
+ * are within the current tick.
+ */
+static uint8_t OcSchedInSync(void) {
+  uint32_t cycles = DWT->CYCCNT;
+  uint32_t into = cycles - oc_sched_cycles_ref -
+                  (TIM2->CNT - oc_sched_tick_ref) * oc_sched_cycles_per_tick;
+
+  return (into + OC_SCHED_SYNC_SLACK) <
+         (oc_sched_cycles_per_tick + 2 * OC_SCHED_SYNC_SLACK);
+}
+
+/**
+ * @brief Cycles from the compare match of `event` to now. The cycle counter
+ * stops while the core sleeps (WFI) or is halted by a debugger; then the
+ * sample is dropped and the reference taken anew.
+ */
+static void OcSchedRecord(const OcSchedEvent* event) {
+  uint32_t latency;
+
+  if (!OcSchedInSync()) {
+    OcSchedAnchor();
+    ++oc_sched_stats.resyncs;
+    return;
+  }
+  latency = DWT->CYCCNT - (oc_sched_cycles_ref +
+                           (event->at - oc_sched_tick_ref) *
+                               oc_sched_cycles_per_tick);
+
+  oc_sched_stats.latency_last = latency;
+  if (latency < oc_sched_stats.latency_min) {
+    oc_sched_stats.latency_min = latency;
+  }
+  if (latency > oc_sched_stats.latency_max) {
+    oc_sched_stats.latency_max = latency;
+  }
+}
+
+/**
+ * @brief Callback and release of an event taken off its queue.
+ */
+static void OcSchedFinish(OcSchedEvent* event) {
+  BspOcSchedCallback callback = event->callback;
+  void* context = event->context;
+
+  event->next = oc_sched_free;
+  oc_sched_free = event;
+  if (callback != 0) callback(context);
+}
+
+/**
+ * @brief Arm the head of the queue of `channel`. Events whose time has
+ * passed meanwhile are executed right away, the pin is forced.
+ * Interrupts disabled.
+ */
+static void OcSchedArm(uint8_t channel) {
+  OcSchedEvent** queue = &oc_sched_queues[channel - 2];
+  OcSchedEvent* event;
+  const OcSchedPin* pin;
+  uint8_t high;
+
+  oc_sched_busy |= (1 << channel);
+  while ((event = *queue) != 0) {
+    OcSchedMode(channel, event->action);
+    if (BspTimeAlarmStart(channel, event->at, oc_sched_handlers[channel - 2]) ==
+        0) {
+      break;
+    }
+
+    // No match, the time passed before the compare was set.
+    *queue = event->next;
+    if (event->action != BSP_OC_SCHED_NONE) {
+      pin = &oc_sched_pins[channel - 2];
+      high = (event->action == BSP_OC_SCHED_SET) ||
+             ((event->action == BSP_OC_SCHED_TOGGLE) &&
+              ((pin->port->IDR & (1UL << pin->pin)) == 0));
+      OcSchedMode(channel, high ? OC_SCHED_FORCE_HIGH : OC_SCHED_FORCE_LOW);
+    }
+    OcSchedMode(channel, OC_SCHED_FROZEN);
+    ++oc_sched_stats.late;
+    OcSchedRecord(event);
+    OcSchedFinish(event);
+  }
+
+  // Idle: a match after the next counter wrap must not change the pin.
+  if (*queue == 0) OcSchedMode(channel, OC_SCHED_FROZEN);
+  oc_sched_busy &= ~(1 << channel);
+}
+
+/**
+ * @brief Compare match of `channel`, TIM2 interrupt. The pin has switched
+ * already.
+ */
+static void OcSchedFired(uint8_t channel) {
+  OcSchedEvent** queue = &oc_sched_queues[channel - 2];
+  OcSchedEvent* event = *queue;
+
+  if (event == 0) return;
+  OcSchedRecord(event);
+  OcSchedMode(channel, OC_SCHED_FROZEN);
+  *queue = event->next;
+  ++oc_sched_stats.fired;
+
+  oc_sched_busy |= (1 << channel);
+  OcSchedFinish(event);
+  OcSchedArm(channel);
+}
+
+void BspOcSchedInit(void) {
+  const OcSchedPin* pin;
+  uint32_t primask;
+  uint32_t shift;
+  uint8_t i;
+
+  // 1. Events: all free.
+  oc_sched_free = 0;
+  for (i = 0; i < BSP_OC_SCHED_EVENTS; ++i) {
+    oc_sched_pool[i].next = oc_sched_free;
+    oc_sched_free = &oc_sched_pool[i];
+  }
+  for (i = 0; i < 3; ++i) oc_sched_queues[i] = 0;
+  oc_sched_busy = 0;
+  BspOcSchedResetStats();
+
+  // 2. Channels 2 and 3: outputs forced low, then frozen. Pins to AF1.
+  RCC->AHBENR |= RCC_AHBENR_GPIOAEN | RCC_AHBENR_GPIOBEN;
+  for (i = 0; i < 2; ++i) {
+    pin = &oc_sched_pins[i];
+    OcSchedMode(i + 2, OC_SCHED_FORCE_LOW);
+    OcSchedMode(i + 2, OC_SCHED_FROZEN);
+    shift = 4 * (pin->pin % 8);
+    pin->port->MODER &= ~(0x03UL << (2 * pin->pin));
+    pin->port->MODER |= (0x02UL << (2 * pin->pin));
+    pin->port->AFR[pin->pin / 8] &= ~(0x0FUL << shift);
+    pin->port->AFR[pin->pin / 8] |= (0x01UL << shift);
+  }
+  OcSchedMode(4, OC_SCHED_FROZEN);
+  TIM2->CCER |= TIM_CCER_CC2E | TIM_CCER_CC3E;
+
+  // 3. Relate the cycle counter to the timebase at the start of a tick.
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  oc_sched_cycles_per_tick = SystemCoreClock / 1000000U;
+  primask = __get_PRIMASK();
+  __disable_irq();
+  OcSchedAnchor();
+  __set_PRIMASK(primask);
+}
+
+uint8_t BspOcSchedAdd(uint8_t channel, uint32_t at, uint8_t action,
+                      BspOcSchedCallback callback, void* context) {
+  OcSchedEvent** link;
+  OcSchedEvent* event;
+  uint32_t primask;
+
+  if ((channel < 2) || (channel > 4) || (action > BSP_OC_SCHED_TOGGLE) ||
+      ((channel == 4) && (action != BSP_OC_SCHED_NONE))) {
+    return BSP_OC_SCHED_ERR_CHANNEL;
+  }
+
+  // The compare interrupt runs at priority 0, only masking all interrupts
+  // keeps it off the queues.
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if ((int32_t)(at - TIM2->CNT) <= 0) {
+    __set_PRIMASK(primask);
+    return BSP_OC_SCHED_ERR_LATE;
+  }
+  event = oc_sched_free;
+  if (event == 0) {
+    ++oc_sched_stats.full;
+    __set_PRIMASK(primask);
+    return BSP_OC_SCHED_ERR_FULL;
+  }
+  oc_sched_free = event->next;
+
+  event->at = at;
+  event->action = action;
+  event->callback = callback;
+  event->context = context;
+
+  // Sorted, after the events with the same time.
+  link = &oc_sched_queues[channel - 2];
+  while ((*link != 0) && ((int32_t)((*link)->at - at) <= 0)) {
+    link = &(*link)->next;
+  }
+  event->next = *link;
+  *link = event;
+  ++oc_sched_stats.scheduled;
+
+  // A new head replaces the armed event. While the channel is being worked
+  // on (from a callback), the head is armed when that is done.
+  if ((link == &oc_sched_queues[channel - 2]) &&
+      ((oc_sched_busy & (1 << channel)) == 0)) {
+    OcSchedArm(channel);
+  }
+  __set_PRIMASK(primask);
+
+  return BSP_OC_SCHED_OK;
+}
+
+void BspOcSchedClear(uint8_t channel) {
+  OcSchedEvent** queue;
+  OcSchedEvent* event;
+  uint32_t primask;
+
+  if ((channel < 2) || (channel > 4)) return;
+  queue = &oc_sched_queues[channel - 2];
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  BspTimeAlarmStop(channel);
+  OcSchedMode(channel, OC_SCHED_FROZEN);
+  while ((event = *queue) != 0) {
+    *queue = event->next;
+    event->next = oc_sched_free;
+    oc_sched_free = event;
+  }
+  __set_PRIMASK(primask);
+}
+
+void BspOcSchedGetStats(BspOcSchedStats* stats) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *stats = oc_sched_stats;
+  __set_PRIMASK(primask);
+}
+
+void BspOcSchedResetStats(void) {
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  oc_sched_stats = (BspOcSchedStats){0};
+  oc_sched_stats.latency_min = 0xFFFFFFFF;
+  __set_PRIMASK(primask);
+}
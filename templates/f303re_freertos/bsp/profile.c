@@ -0,0 +1,81 @@
+/**
+ * @file profile.c
+ * @author DFlubacher
+ * @brief Profiling region table.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "profile.h"
+
+#include <stdint.h>
+
+#include "printf-stdarg.h"
+#include "stm32f3xx.h"
+
+BspProfileRegion bsp_profile_regions[BSP_PROFILE_REGIONS];
+
+static uint8_t profile_nregions;
+
+// Cycles of an empty BEGIN/END pair, included in every measurement.
+static uint32_t profile_overhead;
+
+void BspProfileInit(void) {
+  uint8_t i;
+
+  // Enable the trace block, then the cycle counter.
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  for (i = 0; i < BSP_PROFILE_REGIONS; ++i) {
+    bsp_profile_regions[i] = (BspProfileRegion){0};
+  }
+  profile_nregions = 0;
+
+  // Empty region. Take the fastest run, the first one may wait for the
+  // flash.
+  profile_overhead = 0xFFFFFFFF;
+  for (i = 0; i < 4; ++i) {
+    const uint32_t start = DWT->CYCCNT;
+    const uint32_t cycles = DWT->CYCCNT - start;
+    if (cycles < profile_overhead) profile_overhead = cycles;
+  }
+}
+
+uint8_t BspProfileRegister(const char* name) {
+  if (profile_nregions >= BSP_PROFILE_REGIONS) return BSP_PROFILE_NONE;
+
+  bsp_profile_regions[profile_nregions].name = name;
+  return profile_nregions++;
+}
+
+void BspProfileReset(void) {
+  uint8_t i;
+
+  for (i = 0; i < profile_nregions; ++i) {
+    bsp_profile_regions[i].count = 0;
+    bsp_profile_regions[i].min = 0;
+    bsp_profile_regions[i].max = 0;
+    bsp_profile_regions[i].sum = 0;
+  }
+}
+
+void BspProfileDump(void) {
+  uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+  uint8_t i;
+
+  stm32_printf("\r\nProfile, %u cycles/us, probe overhead %u cycles\r\n",
+               cycles_per_us, profile_overhead);
+  stm32_printf("%-16s %8s %8s %8s %8s %8s\r\n", "region", "count", "min",
+               "max", "mean", "mean/us");
+
+  for (i = 0; i < profile_nregions; ++i) {
+    BspProfileRegion entry = bsp_profile_regions[i];
+    uint32_t mean = (entry.count > 0) ? (uint32_t)(entry.sum / entry.count) : 0;
+
+    stm32_printf("%-16s %8u %8u %8u %8u %8u\r\n", entry.name, entry.count,
+                 entry.min, entry.max, mean, mean / cycles_per_us);
+  }
+}
@@ -0,0 +1,301 @@
+/**
+ * @file pwm.c
+ * @author DFlubacher
+ * @brief General PWM service.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "pwm.h"
+
+#include <stdint.h>
+
+#include "stm32f3xx.h"
+
+// Prescalers tried after the smallest one that fits the counter.
+#define PWM_SEARCH 256
+
+typedef struct {
+  TIM_TypeDef* timer;
+  // Counter width, 16 or 32 bit.
+  uint32_t arr_max;
+  // APB2 (1) or APB1 (0).
+  uint8_t apb2;
+  // Enable bit in RCC->APB1ENR/APB2ENR.
+  uint32_t enable;
+  // Advanced timer: main output enable.
+  uint8_t advanced;
+  BspPwmPin pins[4];
+} PwmTimer;
+
+typedef struct {
+  // Counts per period (ARR + 1), 0 if not initialized.
+  uint32_t period;
+  uint32_t steps;
+  uint32_t duty[4];
+} PwmState;
+
+static const PwmTimer pwm_timers[] = {
+    {TIM1, 0xFFFF, 1, RCC_APB2ENR_TIM1EN, 1,
+     {{GPIOC, 0, 2}, {GPIOC, 1, 2}, {GPIOC, 2, 2}, {GPIOC, 3, 2}}},
+    {TIM2, 0xFFFFFFFF, 0, RCC_APB1ENR_TIM2EN, 0,
+     {{GPIOA, 0, 1}, {GPIOA, 1, 1}, {GPIOB, 10, 1}, {GPIOB, 11, 1}}},
+    {TIM3, 0xFFFF, 0, RCC_APB1ENR_TIM3EN, 0,
+     {{GPIOB, 4, 2}, {GPIOB, 5, 2}, {GPIOB, 0, 2}, {GPIOB, 1, 2}}},
+    {TIM4, 0xFFFF, 0, RCC_APB1ENR_TIM4EN, 0,
+     {{GPIOA, 11, 10}, {GPIOA, 12, 10}, {GPIOB, 8, 2}, {GPIOB, 9, 2}}},
+    {TIM8, 0xFFFF, 1, RCC_APB2ENR_TIM8EN, 1,
+     {{GPIOC, 6, 4}, {GPIOC, 7, 4}, {GPIOC, 8, 4}, {GPIOC, 9, 4}}},
+};
+
+#define PWM_NTIMERS (sizeof(pwm_timers) / sizeof(pwm_timers[0]))
+
+static PwmState pwm_states[PWM_NTIMERS];
+
+static uint8_t PwmFind(const TIM_TypeDef* timer) {
+  uint8_t i;
+
+  for (i = 0; i < PWM_NTIMERS; ++i) {
+    if (pwm_timers[i].timer == timer) break;
+  }
+  return i;
+}
+
+/**
+ * @brief Timer kernel clock: PCLK, doubled if the APB prescaler isn't 1.
+ */
+static uint32_t PwmClock(const PwmTimer* config) {
+  uint32_t ppre = config->apb2
+                      ? (RCC->CFGR & RCC_CFGR_PPRE2_Msk) >> RCC_CFGR_PPRE2_Pos
+                      : (RCC->CFGR & RCC_CFGR_PPRE1_Msk) >> RCC_CFGR_PPRE1_Pos;
+
+  // 0xx: /1, 100: /2, 101: /4, 110: /8, 111: /16.
+  if (ppre < 4) return SystemCoreClock;
+  return (SystemCoreClock >> (ppre - 3)) * 2;
+}
+
+/**
+ * @brief Register enable bit of a channel's GPIO port.
+ */
+static uint32_t PwmPortEnable(const GPIO_TypeDef* port) {
+  if (port == GPIOA) return RCC_AHBENR_GPIOAEN;
+  if (port == GPIOB) return RCC_AHBENR_GPIOBEN;
+  if (port == GPIOC) return RCC_AHBENR_GPIOCEN;
+  if (port == GPIOD) return RCC_AHBENR_GPIODEN;
+  return RCC_AHBENR_GPIOFEN;
+}
+
+/**
+ * @brief Compare value of `duty` (0 ... steps) for the current period.
+ */
+static uint32_t PwmCompare(const PwmState* state, uint32_t duty) {
+  if (duty >= state->steps) return state->period;
+  return (uint32_t)(((uint64_t)duty * state->period) / state->steps);
+}
+
+/**
+ * @brief Prescaler and period for `frequency_hz` with at least `steps`
+ * counts: smallest frequency error, then the largest period.
+ *
+ * @return uint8_t BSP_PWM_OK or BSP_PWM_ERR_RANGE.
+ */
+static uint8_t PwmSolve(uint32_t clock, uint32_t arr_max,
+                        uint32_t frequency_hz, uint32_t steps, uint32_t* psc,
+                        uint32_t* period) {
+  uint64_t best_error = UINT64_MAX;
+  uint64_t counts_max = (uint64_t)arr_max + 1;
+  uint32_t total;
+  uint32_t first;
+  uint32_t p;
+
+  if ((frequency_hz == 0) || (steps < 2) || (frequency_hz > clock)) {
+    return BSP_PWM_ERR_RANGE;
+  }
+
+  // Smallest prescaler that brings the period into the counter.
+  total = clock / frequency_hz;
+  first = (uint32_t)(total / counts_max);
+
+  for (p = first; (p <= 0xFFFF) && (p < first + PWM_SEARCH); ++p) {
+    uint64_t counts =
+        ((uint64_t)clock + (uint64_t)(p + 1) * frequency_hz / 2) /
+        ((uint64_t)(p + 1) * frequency_hz);
+    uint64_t reached;
+    uint64_t error;
+
+    // Coarser with every step, no point going on.
+    if (counts < steps) break;
+    if (counts > counts_max) continue;
+
+    reached = (uint64_t)(p + 1) * counts * frequency_hz;
+    error = (reached > clock) ? (reached - clock) : (clock - reached);
+    if (error < best_error) {
+      best_error = error;
+      *psc = p;
+      *period = (uint32_t)counts;
+      if (error == 0) break;
+    }
+  }
+
+  return (best_error == UINT64_MAX) ? BSP_PWM_ERR_RANGE : BSP_PWM_OK;
+}
+
+/**
+ * @brief Write the compare values of the channels in `mask`. The caller holds
+ * back the update event (UDIS) so that they switch together.
+ */
+static void PwmApply(TIM_TypeDef* timer, const PwmState* state,
+                     uint8_t mask) {
+  volatile uint32_t* ccr = &timer->CCR1;
+  uint8_t i;
+
+  for (i = 0; i < 4; ++i) {
+    if ((mask & (1U << i)) != 0) ccr[i] = PwmCompare(state, state->duty[i]);
+  }
+}
+
+uint8_t BspPwmInit(TIM_TypeDef* timer, uint32_t frequency_hz, uint32_t steps,
+                   uint32_t* actual_hz) {
+  uint8_t index = PwmFind(timer);
+  const PwmTimer* config;
+  PwmState* state;
+  uint32_t psc;
+  uint32_t period;
+  uint32_t clock;
+
+  if (index >= PWM_NTIMERS) return BSP_PWM_ERR_TIMER;
+  config = &pwm_timers[index];
+  state = &pwm_states[index];
+
+  if (config->apb2) {
+    RCC->APB2ENR |= config->enable;
+  } else {
+    RCC->APB1ENR |= config->enable;
+  }
+
+  clock = PwmClock(config);
+  if (PwmSolve(clock, config->arr_max, frequency_hz, steps, &psc, &period) !=
+      BSP_PWM_OK) {
+    return BSP_PWM_ERR_RANGE;
+  }
+
+  *state = (PwmState){period, steps, {0, 0, 0, 0}};
+
+  // Reset the timer configuration, up-counting, auto-reload preload.
+  timer->CR1 = 0x0000;
+  timer->CR2 = 0x0000;
+  timer->SMCR = 0x0000;
+  timer->DIER = 0x0000;
+  timer->CCER = 0x0000;
+  timer->PSC = psc;
+  timer->ARR = period - 1;
+  timer->CR1 |= TIM_CR1_ARPE;
+
+  // PWM mode 1 with compare preload on all channels, outputs still off.
+  timer->CCMR1 = (0x06 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE |
+                 (0x06 << TIM_CCMR1_OC2M_Pos) | TIM_CCMR1_OC2PE;
+  timer->CCMR2 = (0x06 << TIM_CCMR2_OC3M_Pos) | TIM_CCMR2_OC3PE |
+                 (0x06 << TIM_CCMR2_OC4M_Pos) | TIM_CCMR2_OC4PE;
+  timer->CCR1 = 0;
+  timer->CCR2 = 0;
+  timer->CCR3 = 0;
+  timer->CCR4 = 0;
+
+  // Load prescaler, period and compare values.
+  timer->EGR = TIM_EGR_UG;
+
+  if (config->advanced) timer->BDTR |= TIM_BDTR_MOE;
+  timer->CR1 |= TIM_CR1_CEN;
+
+  if (actual_hz != 0) *actual_hz = clock / ((psc + 1) * period);
+  return BSP_PWM_OK;
+}
+
+uint8_t BspPwmSetFrequency(TIM_TypeDef* timer, uint32_t frequency_hz,
+                           uint32_t* actual_hz) {
+  uint8_t index = PwmFind(timer);
+  PwmState* state;
+  uint32_t psc;
+  uint32_t period;
+  uint32_t clock;
+
+  if ((index >= PWM_NTIMERS) || (pwm_states[index].period == 0)) {
+    return BSP_PWM_ERR_TIMER;
+  }
+  state = &pwm_states[index];
+
+  clock = PwmClock(&pwm_timers[index]);
+  if (PwmSolve(clock, pwm_timers[index].arr_max, frequency_hz, state->steps,
+               &psc, &period) != BSP_PWM_OK) {
+    return BSP_PWM_ERR_RANGE;
+  }
+
+  // Prescaler, period and the rescaled compare values, all preloaded: they
+  // switch together at the next update.
+  state->period = period;
+  timer->CR1 |= TIM_CR1_UDIS;
+  timer->PSC = psc;
+  timer->ARR = period - 1;
+  PwmApply(timer, state, 0x0F);
+  timer->CR1 &= ~TIM_CR1_UDIS;
+
+  if (actual_hz != 0) *actual_hz = clock / ((psc + 1) * period);
+  return BSP_PWM_OK;
+}
+
+uint8_t BspPwmChannelInit(TIM_TypeDef* timer, uint8_t channel,
+                          const BspPwmPin* pin) {
+  uint8_t index = PwmFind(timer);
+  uint32_t shift;
+
+  if ((index >= PWM_NTIMERS) || (pwm_states[index].period == 0)) {
+    return BSP_PWM_ERR_TIMER;
+  }
+  if ((channel < 1) || (channel > 4)) return BSP_PWM_ERR_CHANNEL;
+  if (pin == 0) pin = &pwm_timers[index].pins[channel - 1];
+
+  // Alternate function (0b10) and its number.
+  RCC->AHBENR |= PwmPortEnable(pin->port);
+  pin->port->MODER &= ~(0x03UL << (2 * pin->pin));
+  pin->port->MODER |= (0x02UL << (2 * pin->pin));
+  shift = 4 * (pin->pin % 8);
+  pin->port->AFR[pin->pin / 8] &= ~(0x0FUL << shift);
+  pin->port->AFR[pin->pin / 8] |= ((uint32_t)pin->af << shift);
+
+  (void)BspPwmSetDuty(timer, channel, 0);
+  timer->CCER |= (TIM_CCER_CC1E << (4 * (channel - 1)));
+  return BSP_PWM_OK;
+}
+
+uint8_t BspPwmSetDuty(TIM_TypeDef* timer, uint8_t channel, uint32_t duty) {
+  uint8_t index = PwmFind(timer);
+
+  if ((index >= PWM_NTIMERS) || (pwm_states[index].period == 0)) {
+    return BSP_PWM_ERR_TIMER;
+  }
+  if ((channel < 1) || (channel > 4)) return BSP_PWM_ERR_CHANNEL;
+
+  // A single preloaded register switches at the update by itself.
+  pwm_states[index].duty[channel - 1] = duty;
+  (&timer->CCR1)[channel - 1] = PwmCompare(&pwm_states[index], duty);
+  return BSP_PWM_OK;
+}
+
+uint8_t BspPwmSetDuties(TIM_TypeDef* timer, const uint32_t* duties,
+                        uint8_t mask) {
+  uint8_t index = PwmFind(timer);
+  uint8_t i;
+
+  if ((index >= PWM_NTIMERS) || (pwm_states[index].period == 0)) {
+    return BSP_PWM_ERR_TIMER;
+  }
+
+  for (i = 0; i < 4; ++i) {
+    if ((mask & (1U << i)) != 0) pwm_states[index].duty[i] = duties[i];
+  }
+  timer->CR1 |= TIM_CR1_UDIS;
+  PwmApply(timer, &pwm_states[index], mask);
+  timer->CR1 &= ~TIM_CR1_UDIS;
+  return BSP_PWM_OK;
+}
@@ -0,0 +1,274 @@
+/**
+ * @file pwm_input.c
+ * @author DFlubacher
+ * @brief PWM input measurement service.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "pwm_input.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "bsp_timers.h"
+#include "queue.h"
+#include "stm32f3xx.h"
+
+// Counts per period kept by the ranging: below RANGE_LOW the prescaler is
+// lowered, an overflow raises it. A new prescaler aims at RANGE_TARGET.
+#define PWM_INPUT_RANGE_LOW 8192U
+#define PWM_INPUT_RANGE_TARGET 32768U
+
+#define PWM_INPUT_SCALE_MAX 65536U
+
+#define PWM_INPUT_TIMEOUT_CLOCKS \
+  ((uint64_t)BSP_PWM_INPUT_TIMEOUT_MS * (BSP_PWM_INPUT_CLOCK_HZ / 1000U))
+
+static QueueHandle_t pwm_input_mailbox;
+
+// Interrupt state. The counter runs in segments: from the reset to an
+// overflow, between overflows, to the next rising edge. `base` are the clocks
+// before the current segment, `scale` its prescaler + 1. A prescaler write
+// is loaded at the next overflow or reset (update event).
+static uint64_t pwm_input_base;
+static uint32_t pwm_input_scale;
+static uint32_t pwm_input_pending;
+// High time of the current period, once the falling edge is placed.
+static uint64_t pwm_input_high;
+static uint8_t pwm_input_high_valid;
+// A rising edge has started a period.
+static uint8_t pwm_input_started;
+
+static BspPwmInputReading pwm_input_reading;
+
+/**
+ * @brief Write a new prescaler, loaded at the next update event.
+ */
+static void PwmInputSetScale(uint32_t scale) {
+  if (scale < 1) scale = 1;
+  if (scale > PWM_INPUT_SCALE_MAX) scale = PWM_INPUT_SCALE_MAX;
+  if (scale == pwm_input_pending) return;
+  TIM3->PSC = scale - 1;
+  pwm_input_pending = scale;
+}
+
+/**
+ * @brief Largest prescaler + 1 for a segment starting `start` clocks into the
+ * period that ends by the timeout (checked only at overflows), at least 1.
+ */
+static uint32_t PwmInputScaleLimit(uint64_t start) {
+  if (start + 0x10000ULL >= PWM_INPUT_TIMEOUT_CLOCKS) return 1;
+  return (uint32_t)((PWM_INPUT_TIMEOUT_CLOCKS - start) >> 16);
+}
+
+static void PwmInputPublish(BaseType_t* woken) {
+  xQueueOverwriteFromISR(pwm_input_mailbox, &pwm_input_reading, woken);
+}
+
+/**
+ * @brief First order filter, the first period after a start or a loss of the
+ * signal is taken as is.
+ */
+static void PwmInputFilter(uint64_t period, uint64_t high) {
+  BspPwmInputReading* reading = &pwm_input_reading;
+
+  if (reading->period_clocks == 0) {
+    reading->period_clocks = period;
+    reading->high_clocks = high;
+  } else {
+    reading->period_clocks =
+        reading->period_clocks - (reading->period_clocks >>
+                                  BSP_PWM_INPUT_FILTER_SHIFT) +
+        (period >> BSP_PWM_INPUT_FILTER_SHIFT);
+    reading->high_clocks =
+        reading->high_clocks -
+        (reading->high_clocks >> BSP_PWM_INPUT_FILTER_SHIFT) +
+        (high >> BSP_PWM_INPUT_FILTER_SHIFT);
+  }
+}
+
+void BspPwmInputInit(void) {
+  if (pwm_input_mailbox == NULL) {
+    pwm_input_mailbox = xQueueCreate(1, sizeof(BspPwmInputReading));
+  }
+
+  // 1. Configure PB4.
+  // Enable port B.
+  RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
+
+  // Set PB4 to mode 'Alternate Function' (0b10), AF2 (TIM3_CH1).
+  GPIOB->MODER &= ~GPIO_MODER_MODER4_Msk;
+  GPIOB->MODER |= (0x02 << GPIO_MODER_MODER4_Pos);
+  GPIOB->AFR[0] &= ~GPIO_AFRL_AFRL4_Msk;
+  GPIOB->AFR[0] |= (0x02 << GPIO_AFRL_AFRL4_Pos);
+
+  // 2. Configure Timer 3.
+  RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+  TIM3->CR1 = 0x0000;
+  TIM3->CR2 = 0x0000;
+  TIM3->DIER = 0x0000;
+  TIM3->CCER = 0x0000;
+  TIM3->ARR = 0xFFFF;
+
+  // Start at full resolution.
+  pwm_input_pending = 0;
+  PwmInputSetScale(1);
+  pwm_input_scale = 1;
+  pwm_input_base = 0;
+  pwm_input_high_valid = 0;
+  pwm_input_started = 0;
+  pwm_input_reading = (BspPwmInputReading){0};
+
+  // CC1: input on TI1, CC2: input on TI1. Filter: 8 samples at 48 MHz.
+  TIM3->CCMR1 = (0x01 << TIM_CCMR1_CC1S_Pos) | (0x02 << TIM_CCMR1_CC2S_Pos) |
+                (0x03 << TIM_CCMR1_IC1F_Pos) | (0x03 << TIM_CCMR1_IC2F_Pos);
+  TIM3->CCMR2 = 0x0000;
+
+  // CC1 rising edge (period), CC2 falling edge (high time).
+  TIM3->CCER = TIM_CCER_CC1E | TIM_CCER_CC2P | TIM_CCER_CC2E;
+
+  // Reset mode on TI1FP1 (0b101): the rising edge restarts the counter.
+  TIM3->SMCR = (0x05 << TIM_SMCR_TS_Pos) | (0x04 << TIM_SMCR_SMS_Pos);
+
+  // Only overflows raise the update interrupt, not the resets. Load the
+  // prescaler now.
+  TIM3->CR1 = TIM_CR1_URS;
+  TIM3->EGR = TIM_EGR_UG;
+  TIM3->SR = 0;
+
+  // One interrupt per period (CC1) and per overflow. The handler publishes
+  // to the mailbox.
+  TIM3->DIER = TIM_DIER_CC1IE | TIM_DIER_UIE;
+  NVIC_SetPriority(TIM3_IRQn, 6);
+  NVIC_EnableIRQ(TIM3_IRQn);
+
+  TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+void BspPwmInputStop(void) {
+  TIM3->CR1 &= ~TIM_CR1_CEN;
+  TIM3->DIER = 0x0000;
+  NVIC_DisableIRQ(TIM3_IRQn);
+}
+
+uint8_t BspPwmInputRead(BspPwmInputReading* reading, TickType_t timeout) {
+  if (xQueueReceive(pwm_input_mailbox, reading, timeout) != pdTRUE) return 1;
+
+  if (reading->period_clocks > 0) {
+    reading->frequency_hz =
+        (float)BSP_PWM_INPUT_CLOCK_HZ / (float)reading->period_clocks;
+    reading->duty =
+        (float)reading->high_clocks / (float)reading->period_clocks;
+  } else {
+    reading->frequency_hz = 0.0f;
+    reading->duty = 0.0f;
+  }
+  return 0;
+}
+
+void TIM3_IRQHandler(void) {
+  BaseType_t woken = pdFALSE;
+  uint32_t status = TIM3->SR;
+  uint32_t ccr2 = 0;
+  uint32_t counts;
+  uint8_t fall;
+  uint8_t overflowed;
+  uint8_t range;
+  uint64_t period;
+  uint32_t limit;
+  uint32_t scale;
+
+  // ===   Overflow: end of a segment   ========================================
+  // Handled first: pending together with a capture, it happened before it
+  // (the capture resets the counter).
+  if ((status & TIM_SR_UIF) != 0) {
+    TIM3->SR = ~(uint32_t)TIM_SR_UIF;
+
+    // A falling edge in the ending segment has a large count, a small count
+    // is past the overflow. Reading CCR2 clears its flag.
+    fall = ((TIM3->SR & TIM_SR_CC2IF) != 0) && !pwm_input_high_valid;
+    if (fall) ccr2 = TIM3->CCR2;
+    if (fall && (ccr2 >= 0x8000)) {
+      pwm_input_high = pwm_input_base + (uint64_t)ccr2 * pwm_input_scale;
+      pwm_input_high_valid = 1;
+    }
+
+    pwm_input_base += 0x10000ULL * pwm_input_scale;
+    pwm_input_scale = pwm_input_pending;
+
+    if (fall && (ccr2 < 0x8000)) {
+      pwm_input_high = pwm_input_base + (uint64_t)ccr2 * pwm_input_scale;
+      pwm_input_high_valid = 1;
+    }
+
+    // Coarser ranging right away, limits the overflow rate without a signal.
+    // The new prescaler takes effect after the current segment.
+    scale = pwm_input_pending * 16;
+    limit = PwmInputScaleLimit(pwm_input_base + 0x10000ULL * pwm_input_scale);
+    PwmInputSetScale((scale < limit) ? scale : limit);
+
+    if (pwm_input_base >= PWM_INPUT_TIMEOUT_CLOCKS) {
+      // No signal. Start over with the next rising edge.
+      pwm_input_base = 0;
+      pwm_input_high_valid = 0;
+      pwm_input_started = 0;
+      if (pwm_input_reading.period_clocks != 0) {
+        pwm_input_reading.period_clocks = 0;
+        pwm_input_reading.high_clocks = 0;
+        PwmInputPublish(&woken);
+      }
+    }
+  }
+
+  // ===   Rising edge: end of the period   ====================================
+  if ((status & TIM_SR_CC1IF) != 0) {
+    // Reading CCR1 clears the flag.
+    counts = TIM3->CCR1;
+    overflowed = (pwm_input_base != 0);
+    period = pwm_input_base + (uint64_t)counts * pwm_input_scale;
+
+    // Overcapture: the falling edge of the new period came before this
+    // handler (short low time), the high time of the ending period is lost.
+    status = TIM3->SR;
+    if ((status & TIM_SR_CC2OF) != 0) {
+      TIM3->SR = ~(uint32_t)TIM_SR_CC2OF;
+      pwm_input_high_valid = 0;
+      fall = 1;
+    } else {
+      if (((status & TIM_SR_CC2IF) != 0) && !pwm_input_high_valid) {
+        pwm_input_high =
+            pwm_input_base + (uint64_t)TIM3->CCR2 * pwm_input_scale;
+        pwm_input_high_valid = 1;
+      }
+      fall = 0;
+    }
+
+    // The first rising edge only starts a period.
+    if (pwm_input_started && pwm_input_high_valid) {
+      PwmInputFilter(period, pwm_input_high);
+      pwm_input_reading.timestamp_us = BspTimeNowUs();
+      ++pwm_input_reading.periods;
+      PwmInputPublish(&woken);
+    }
+
+    // The reset loaded the pending prescaler, a new one takes effect with
+    // the next reset. Range from the counts of the ended period, dividing
+    // only on a change.
+    range = overflowed ||
+            ((counts < PWM_INPUT_RANGE_LOW) && (pwm_input_scale > 1));
+    pwm_input_scale = pwm_input_pending;
+    if (range) {
+      scale = (uint32_t)(period / PWM_INPUT_RANGE_TARGET) + 1;
+      limit = PwmInputScaleLimit(0x10000ULL * pwm_input_scale);
+      PwmInputSetScale((scale < limit) ? scale : limit);
+    }
+    pwm_input_base = 0;
+    pwm_input_started = 1;
+    pwm_input_high_valid = fall;
+    if (fall) pwm_input_high = (uint64_t)TIM3->CCR2 * pwm_input_scale;
+  }
+
+  portYIELD_FROM_ISR(woken);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file regmap.c
+ * @author DFlubacher
+ * @brief Double-buffered register map.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "regmap.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Swap banks if the application committed a new frame.
+ * Called at transaction boundaries only.
+ *
+ * @param map
+ */
+static void RegMapLatch(BspRegMap* map) {
+  if (map->pending) {
+    map->front ^= 1;
+    map->pending = 0;
+  }
+}
+
+void BspRegMapInit(BspRegMap* map, BspRegMapWriteCallback on_write,
+                   void* context) {
+  memset(map->bank, 0, sizeof(map->bank));
+  map->front = 0;
+  map->pending = 0;
+  map->pointer = 0;
+  map->pointer_phase = 0;
+  map->on_write = on_write;
+  map->context = context;
+}
+
+uint8_t* BspRegMapBegin(BspRegMap* map) {
+  uint8_t* back;
+
+  // Withdraw the commit first: once `pending` is cleared, the interrupt does
+  // not swap anymore and the back bank belongs to the application.
+  map->pending = 0;
+  back = map->bank[map->front ^ 1];
+
+  // Start from the frame the host currently sees, so partial updates work.
+  memcpy(back, map->bank[map->front], BSP_REGMAP_SIZE);
+
+  return back;
+}
+
+void BspRegMapCommit(BspRegMap* map) { map->pending = 1; }
+
+void BspRegMapHostStart(BspRegMap* map, uint8_t read) {
+  // A read continues at the current pointer (also after a repeated START).
+  map->pointer_phase = !read;
+}
+
+void BspRegMapHostWrite(BspRegMap* map, uint8_t value) {
+  if (map->pointer_phase) {
+    // Register pointer, start of a new access: take the latest frame.
+    map->pointer = (value < BSP_REGMAP_SIZE) ? value : 0;
+    map->pointer_phase = 0;
+    RegMapLatch(map);
+    return;
+  }
+
+  // Register data, handed to the application.
+  if (map->on_write != 0) {
+    map->on_write(map->pointer, value, map->context);
+  }
+  map->pointer = (map->pointer + 1 < BSP_REGMAP_SIZE) ? map->pointer + 1 : 0;
+}
+
+uint8_t BspRegMapHostReadFirst(BspRegMap* map) {
+  return map->bank[map->front][map->pointer];
+}
+
+uint8_t BspRegMapHostReadNext(BspRegMap* map) {
+  map->pointer = (map->pointer + 1 < BSP_REGMAP_SIZE) ? map->pointer + 1 : 0;
+  return map->bank[map->front][map->pointer];
+}
+
+void BspRegMapHostStop(BspRegMap* map) {
+  map->pointer_phase = 0;
+  RegMapLatch(map);
+}
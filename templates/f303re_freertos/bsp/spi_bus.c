@@ -0,0 +1,111 @@
+/**
+ * @file spi_bus.c
+ * @author DFlubacher
+ * @brief SPI1 bus manager.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "spi_bus.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "comms.h"
+#include "semphr.h"
+#include "task.h"
+
+// Owner of SPI1. A mutex rather than a binary semaphore for the priority
+// inheritance.
+static SemaphoreHandle_t bus_mutex;
+
+// Completion of one DMA segment, lives on the stack of the waiting task.
+typedef struct {
+  TaskHandle_t task;
+  volatile uint8_t status;
+} SpiBusWait;
+
+/**
+ * @brief DMA completion (interrupt context): wake the waiting task.
+ *
+ * @param status
+ * @param context SpiBusWait of the waiting task.
+ */
+static void SpiBusDone(uint8_t status, void* context) {
+  SpiBusWait* wait = (SpiBusWait*)context;
+  BaseType_t higher_priority_task_woken = pdFALSE;
+
+  wait->status = status;
+  vTaskNotifyGiveFromISR(wait->task, &higher_priority_task_woken);
+  portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+void BspSpiBusInit(void) {
+  BspSPI1_Init();
+  bus_mutex = xSemaphoreCreateMutex();
+  configASSERT(bus_mutex != NULL);
+}
+
+void BspSpiBusRegister(const BspSpiDevice* device) {
+  BspSPI1_DeviceInit(device);
+}
+
+uint8_t BspSpiBusTransact(const BspSpiDevice* device,
+                          const BspSpiSegment* segments, uint8_t nsegments,
+                          TickType_t timeout) {
+  SpiBusWait wait;
+  uint8_t result = BSP_SPI_OK;
+  uint8_t i;
+
+  if (xSemaphoreTake(bus_mutex, timeout) != pdTRUE) return BSP_SPI_ERR_BUSY;
+
+  wait.task = xTaskGetCurrentTaskHandle();
+  BspSPI1_Select(device);
+
+  for (i = 0; (i < nsegments) && (result == BSP_SPI_OK); ++i) {
+    if (segments[i].length == 0) continue;
+
+    wait.status = BSP_SPI_OK;
+    result = BspSPI1_TransferStart(segments[i].tx, segments[i].rx,
+                                   segments[i].length, SpiBusDone, &wait);
+    if (result != BSP_SPI_OK) break;
+
+    if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+      BspSPI1_TransferAbort();
+      // The segment may have completed between the timeout and the abort,
+      // drop the late notification.
+      (void)ulTaskNotifyTake(pdTRUE, 0);
+      result = BSP_SPI_ERR_TIMEOUT;
+    } else {
+      result = wait.status;
+    }
+  }
+
+  BspSPI1_Deselect(device);
+  xSemaphoreGive(bus_mutex);
+
+  return result;
+}
+
+uint8_t BspSpiBusRead(const BspSpiDevice* device, const uint8_t* command,
+                      uint16_t command_length, uint8_t* data, uint16_t length,
+                      TickType_t timeout) {
+  BspSpiSegment segments[2] = {
+      {command, 0, command_length},
+      {0, data, length},
+  };
+
+  return BspSpiBusTransact(device, segments, 2, timeout);
+}
+
+uint8_t BspSpiBusWrite(const BspSpiDevice* device, const uint8_t* command,
+                       uint16_t command_length, const uint8_t* data,
+                       uint16_t length, TickType_t timeout) {
+  BspSpiSegment segments[2] = {
+      {command, 0, command_length},
+      {data, 0, length},
+  };
+
+  return BspSpiBusTransact(device, segments, 2, timeout);
+}
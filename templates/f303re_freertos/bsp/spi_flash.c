@@ -0,0 +1,197 @@
+/**
+ * @file spi_flash.c
+ * @author DFlubacher
+ * @brief SPI NOR flash driver.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "spi_flash.h"
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "comms.h"
+#include "log_store.h"
+#include "spi_bus.h"
+#include "task.h"
+
+// ===   Commands   ===========================================================
+#define FLASH_CMD_WRITE_ENABLE 0x06
+#define FLASH_CMD_PAGE_PROGRAM 0x02
+#define FLASH_CMD_SECTOR_ERASE 0x20
+#define FLASH_CMD_FAST_READ 0x0B
+#define FLASH_CMD_READ_STATUS 0x05
+#define FLASH_CMD_JEDEC_ID 0x9F
+
+// Status register 1: write in progress.
+#define FLASH_STATUS_WIP 0x01
+
+#define FLASH_TIMEOUT pdMS_TO_TICKS(10)
+
+// Largest DMA transfer. Reads wait for the transfer time on top of
+// FLASH_TIMEOUT (`FlashReadTimeout()`).
+#define FLASH_READ_CHUNK 0xFFFF
+
+static const BspSpiDevice* flash;
+static BspLogFlash flash_log;
+
+/**
+ * @brief Command byte followed by a 24-bit address.
+ */
+static void FlashCommand(uint8_t* command, uint8_t opcode, uint32_t address) {
+  command[0] = opcode;
+  command[1] = (uint8_t)(address >> 16);
+  command[2] = (uint8_t)(address >> 8);
+  command[3] = (uint8_t)address;
+}
+
+/**
+ * @brief Timeout of a fast read of `length` bytes: the transfer at the
+ * slowest clock the bus picks for the device (at most a factor 2 below
+ * max_clock_hz, at least 48 MHz / 256) plus FLASH_TIMEOUT.
+ */
+static TickType_t FlashReadTimeout(uint16_t length) {
+  uint32_t clock_hz = flash->max_clock_hz / 2;
+  uint32_t ms;
+
+  if (clock_hz < SystemCoreClock / 256) clock_hz = SystemCoreClock / 256;
+  ms = (uint32_t)(((uint64_t)(length + 5) * 8 * 1000 + clock_hz - 1) /
+                  clock_hz);
+  return FLASH_TIMEOUT + pdMS_TO_TICKS(ms + 1);
+}
+
+static uint8_t FlashWriteEnable(void) {
+  uint8_t command = FLASH_CMD_WRITE_ENABLE;
+
+  return BspSpiBusWrite(flash, &command, 1, 0, 0, FLASH_TIMEOUT);
+}
+
+// ===   Log store backend   ==================================================
+
+static uint8_t FlashLogRead(void* context, uint32_t address, uint8_t* data,
+                            uint32_t length) {
+  return BspSpiFlashRead(address, data, length);
+}
+
+static uint8_t FlashLogProgram(void* context, uint32_t address,
+                               const uint8_t* data, uint32_t length) {
+  return BspSpiFlashProgram(address, data, (uint16_t)length);
+}
+
+static uint8_t FlashLogErase(void* context, uint32_t address) {
+  return BspSpiFlashEraseSector(address);
+}
+
+static uint8_t FlashLogBusy(void* context) { return BspSpiFlashBusy(); }
+
+uint8_t BspSpiFlashInit(const BspSpiDevice* device, BspSpiFlashId* id) {
+  uint8_t command = FLASH_CMD_JEDEC_ID;
+  uint8_t jedec[3];
+
+  flash = device;
+  BspSpiBusRegister(device);
+
+  if (BspSpiBusRead(flash, &command, 1, jedec, 3, FLASH_TIMEOUT) !=
+      BSP_SPI_OK) {
+    return BSP_FLASH_ERR_BUS;
+  }
+
+  // No device (MISO floating or pulled) or beyond 3-byte addressing.
+  if ((jedec[0] == 0x00) || (jedec[0] == 0xFF) || (jedec[2] < 0x10) ||
+      (jedec[2] > 0x18)) {
+    return BSP_FLASH_ERR_ID;
+  }
+
+  flash_log.read = FlashLogRead;
+  flash_log.program = FlashLogProgram;
+  flash_log.erase = FlashLogErase;
+  flash_log.busy = FlashLogBusy;
+  flash_log.context = 0;
+  flash_log.size = 1UL << jedec[2];
+  flash_log.sector_size = BSP_FLASH_SECTOR_SIZE;
+
+  if (id != 0) {
+    id->manufacturer = jedec[0];
+    id->memory_type = jedec[1];
+    id->capacity = jedec[2];
+    id->size = flash_log.size;
+  }
+
+  return BSP_FLASH_OK;
+}
+
+uint8_t BspSpiFlashRead(uint32_t address, uint8_t* data, uint32_t length) {
+  // Fast read: address and one dummy byte.
+  uint8_t command[5];
+  uint16_t chunk;
+
+  while (length > 0) {
+    chunk = (length > FLASH_READ_CHUNK) ? FLASH_READ_CHUNK : (uint16_t)length;
+    FlashCommand(command, FLASH_CMD_FAST_READ, address);
+    command[4] = 0x00;
+    if (BspSpiBusRead(flash, command, 5, data, chunk,
+                      FlashReadTimeout(chunk)) != BSP_SPI_OK) {
+      return BSP_FLASH_ERR_BUS;
+    }
+    address += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+
+  return BSP_FLASH_OK;
+}
+
+uint8_t BspSpiFlashProgram(uint32_t address, const uint8_t* data,
+                           uint16_t length) {
+  uint8_t command[4];
+
+  if (FlashWriteEnable() != BSP_SPI_OK) return BSP_FLASH_ERR_BUS;
+
+  FlashCommand(command, FLASH_CMD_PAGE_PROGRAM, address);
+  if (BspSpiBusWrite(flash, command, 4, data, length, FLASH_TIMEOUT) !=
+      BSP_SPI_OK) {
+    return BSP_FLASH_ERR_BUS;
+  }
+
+  return BSP_FLASH_OK;
+}
+
+uint8_t BspSpiFlashEraseSector(uint32_t address) {
+  uint8_t command[4];
+
+  if (FlashWriteEnable() != BSP_SPI_OK) return BSP_FLASH_ERR_BUS;
+
+  FlashCommand(command, FLASH_CMD_SECTOR_ERASE, address);
+  if (BspSpiBusWrite(flash, command, 4, 0, 0, FLASH_TIMEOUT) != BSP_SPI_OK) {
+    return BSP_FLASH_ERR_BUS;
+  }
+
+  return BSP_FLASH_OK;
+}
+
+uint8_t BspSpiFlashBusy(void) {
+  uint8_t command = FLASH_CMD_READ_STATUS;
+  uint8_t status;
+
+  if (BspSpiBusRead(flash, &command, 1, &status, 1, FLASH_TIMEOUT) !=
+      BSP_SPI_OK) {
+    return 1;
+  }
+
+  return (status & FLASH_STATUS_WIP) != 0;
+}
+
+uint8_t BspSpiFlashWait(TickType_t timeout) {
+  TickType_t start = xTaskGetTickCount();
+
+  while (BspSpiFlashBusy()) {
+    if ((xTaskGetTickCount() - start) > timeout) return BSP_FLASH_ERR_TIMEOUT;
+    vTaskDelay(1);
+  }
+
+  return BSP_FLASH_OK;
+}
+
+const BspLogFlash* BspSpiFlashLog(void) { return &flash_log; }
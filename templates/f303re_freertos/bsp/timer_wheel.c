@@ -0,0 +1,175 @@
+/**
+ * @file timer_wheel.c
+ * @author DFlubacher
+ * @brief Hierarchical timer wheel.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "timer_wheel.h"
+
+#include <stdint.h>
+
+#define WHEEL_MASK (BSP_WHEEL_SLOTS - 1)
+
+static void WheelLink(BspWheelTimer** head, BspWheelTimer* timer) {
+  timer->next = *head;
+  if (timer->next != 0) timer->next->pprev = &timer->next;
+  timer->pprev = head;
+  *head = timer;
+}
+
+static void WheelUnlink(BspWheelTimer* timer) {
+  *timer->pprev = timer->next;
+  if (timer->next != 0) timer->next->pprev = timer->pprev;
+  timer->next = 0;
+  timer->pprev = 0;
+}
+
+/**
+ * @brief Slot of the lowest level whose range covers the remaining time.
+ */
+static void WheelInsert(BspTimerWheel* wheel, BspWheelTimer* timer) {
+  uint32_t delta = timer->expires - wheel->now;
+  uint32_t target = timer->expires;
+  uint8_t level;
+
+  // Too far out: park in the last slot of the top level to come around.
+  if (delta >= BSP_WHEEL_RANGE) {
+    delta = BSP_WHEEL_RANGE - 1;
+    target = wheel->now + delta;
+  }
+
+  for (level = 0; level < (BSP_WHEEL_LEVELS - 1); ++level) {
+    if (delta < (1UL << (BSP_WHEEL_BITS * (level + 1)))) break;
+  }
+
+  WheelLink(
+      &wheel->slots[level][(target >> (BSP_WHEEL_BITS * level)) & WHEEL_MASK],
+      timer);
+}
+
+/**
+ * @brief Take the list of a slot, the first timer's link then points to
+ * `list`, so that timers can still be cancelled from it.
+ */
+static BspWheelTimer* WheelDetach(BspWheelTimer** slot, BspWheelTimer** list) {
+  *list = *slot;
+  *slot = 0;
+  if (*list != 0) (*list)->pprev = list;
+  return *list;
+}
+
+/**
+ * @brief Move the timers of slot `index` of `level` down.
+ *
+ * @return uint8_t 1 if the index was 0, the level above is due as well.
+ */
+static uint8_t WheelCascade(BspTimerWheel* wheel, uint8_t level) {
+  uint32_t index = (wheel->now >> (BSP_WHEEL_BITS * level)) & WHEEL_MASK;
+  BspWheelTimer* list;
+  BspWheelTimer* timer;
+
+  WheelDetach(&wheel->slots[level][index], &list);
+  while ((timer = list) != 0) {
+    WheelUnlink(timer);
+    WheelInsert(wheel, timer);
+    ++wheel->stats.cascaded;
+  }
+  return index == 0;
+}
+
+static uint32_t WheelLock(const BspTimerWheel* wheel) {
+  return (wheel->lock != 0) ? wheel->lock() : 0;
+}
+
+static void WheelUnlock(const BspTimerWheel* wheel, uint32_t state) {
+  if (wheel->lock != 0) wheel->unlock(state);
+}
+
+void BspTimerWheelInit(BspTimerWheel* wheel, uint32_t now) {
+  uint8_t level;
+  uint32_t i;
+
+  wheel->now = now;
+  for (level = 0; level < BSP_WHEEL_LEVELS; ++level) {
+    for (i = 0; i < BSP_WHEEL_SLOTS; ++i) wheel->slots[level][i] = 0;
+  }
+  wheel->stats = (BspWheelStats){0};
+  wheel->lock = 0;
+  wheel->unlock = 0;
+}
+
+void BspTimerWheelSetLock(BspTimerWheel* wheel, BspWheelLock lock,
+                          BspWheelUnlock unlock) {
+  wheel->lock = lock;
+  wheel->unlock = unlock;
+}
+
+void BspTimerWheelAdvance(BspTimerWheel* wheel, uint32_t now) {
+  BspWheelTimer* list;
+  BspWheelTimer* timer;
+  uint32_t state;
+  uint8_t level;
+
+  state = WheelLock(wheel);
+  while ((int32_t)(now - wheel->now) > 0) {
+    ++wheel->now;
+
+    // Start of a level 1 range: cascade, and the levels above at the start
+    // of theirs.
+    if ((wheel->now & WHEEL_MASK) == 0) {
+      for (level = 1; level < BSP_WHEEL_LEVELS; ++level) {
+        if (!WheelCascade(wheel, level)) break;
+      }
+    }
+
+    // Everything in this level 0 slot is due now. Callbacks may arm and
+    // cancel (also timers still in `list`).
+    WheelDetach(&wheel->slots[0][wheel->now & WHEEL_MASK], &list);
+    while ((timer = list) != 0) {
+      WheelUnlink(timer);
+      ++wheel->stats.fired;
+      WheelUnlock(wheel, state);
+      timer->callback(timer, timer->context);
+      state = WheelLock(wheel);
+    }
+  }
+  WheelUnlock(wheel, state);
+}
+
+void BspWheelTimerInit(BspWheelTimer* timer, BspWheelCallback callback,
+                       void* context) {
+  timer->next = 0;
+  timer->pprev = 0;
+  timer->expires = 0;
+  timer->callback = callback;
+  timer->context = context;
+}
+
+void BspWheelTimerArm(BspTimerWheel* wheel, BspWheelTimer* timer,
+                      uint32_t ticks) {
+  uint32_t state = WheelLock(wheel);
+
+  if (timer->pprev != 0) WheelUnlink(timer);
+  // The slot of the current tick has been processed already.
+  timer->expires = wheel->now + ((ticks > 0) ? ticks : 1);
+  WheelInsert(wheel, timer);
+  ++wheel->stats.armed;
+  WheelUnlock(wheel, state);
+}
+
+void BspWheelTimerCancel(BspTimerWheel* wheel, BspWheelTimer* timer) {
+  uint32_t state = WheelLock(wheel);
+
+  if (timer->pprev != 0) {
+    WheelUnlink(timer);
+    ++wheel->stats.cancelled;
+  }
+  WheelUnlock(wheel, state);
+}
+
+uint8_t BspWheelTimerActive(const BspWheelTimer* timer) {
+  return timer->pprev != 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file ubx.c
+ * @author DFlubacher
+ * @brief Incremental UBX parser.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "ubx.h"
+
+#include <stdint.h>
+
+#define UBX_SYNC_1 0xB5
+#define UBX_SYNC_2 0x62
+
+// Sync, class, ID, length and checksum.
+#define UBX_OVERHEAD 8
+
+enum {
+  UBX_STATE_SYNC_1,
+  UBX_STATE_SYNC_2,
+  UBX_STATE_CLASS,
+  UBX_STATE_ID,
+  UBX_STATE_LENGTH_1,
+  UBX_STATE_LENGTH_2,
+  UBX_STATE_PAYLOAD,
+  UBX_STATE_CK_A,
+  UBX_STATE_CK_B,
+};
+
+/**
+ * @brief 8-bit Fletcher checksum over class, ID, length and payload.
+ */
+static void UbxChecksum(BspUbxParser* parser, uint8_t value) {
+  parser->ck_a += value;
+  parser->ck_b += parser->ck_a;
+}
+
+/**
+ * @brief Build the in-place message of the frame just validated and call its
+ * route.
+ *
+ * @param parser
+ */
+static void UbxDispatch(BspUbxParser* parser) {
+  BspUbxMessage message;
+  uint16_t first = parser->size - parser->payload;
+  uint8_t i;
+
+  message.msg_class = parser->msg_class;
+  message.msg_id = parser->msg_id;
+  message.length = parser->length;
+  message.part[0] = &parser->ring[parser->payload];
+  message.part[1] = parser->ring;
+  if (parser->length <= first) {
+    message.part_length[0] = parser->length;
+    message.part_length[1] = 0;
+  } else {
+    message.part_length[0] = first;
+    message.part_length[1] = parser->length - first;
+  }
+
+  ++parser->stats.frames;
+  for (i = 0; i < parser->nroutes; ++i) {
+    if ((parser->routes[i].msg_class == message.msg_class) &&
+        (parser->routes[i].msg_id == message.msg_id)) {
+      parser->routes[i].handler(&message, parser->routes[i].context);
+      return;
+    }
+  }
+  ++parser->stats.unhandled;
+}
+
+void BspUbxInit(BspUbxParser* parser, const uint8_t* ring, uint16_t size,
+                const BspUbxRoute* routes, uint8_t nroutes) {
+  parser->ring = ring;
+  parser->size = size;
+  parser->routes = routes;
+  parser->nroutes = nroutes;
+  parser->read = 0;
+  parser->state = UBX_STATE_SYNC_1;
+  parser->stats = (BspUbxStats){0};
+}
+
+void BspUbxParse(BspUbxParser* parser, uint16_t write) {
+  uint16_t read = parser->read;
+  uint16_t n;
+  uint8_t value;
+
+  while (read != write) {
+    // ===   Payload: checksum the contiguous span in one go   ================
+    if (parser->state == UBX_STATE_PAYLOAD) {
+      n = ((write > read) ? write : parser->size) - read;
+      if (n > (parser->length - parser->count)) {
+        n = parser->length - parser->count;
+      }
+      parser->count += n;
+      while (n-- > 0) {
+        UbxChecksum(parser, parser->ring[read++]);
+      }
+      if (read == parser->size) read = 0;
+      if (parser->count == parser->length) parser->state = UBX_STATE_CK_A;
+      continue;
+    }
+
+    value = parser->ring[read];
+    if (++read == parser->size) read = 0;
+
+    switch (parser->state) {
+      case UBX_STATE_SYNC_1:
+        // 0xFF is the idle filler of the SPI interface.
+        if (value == UBX_SYNC_1) {
+          parser->start = ((read == 0) ? parser->size : read) - 1;
+          parser->state = UBX_STATE_SYNC_2;
+        } else {
+          ++parser->stats.skipped;
+        }
+        break;
+
+      case UBX_STATE_SYNC_2:
+        if (value == UBX_SYNC_2) {
+          parser->ck_a = 0;
+          parser->ck_b = 0;
+          parser->state = UBX_STATE_CLASS;
+        } else if (value != UBX_SYNC_1) {
+          parser->stats.skipped += 2;
+          parser->state = UBX_STATE_SYNC_1;
+        } else {
+          // Repeated first sync character.
+          parser->start = ((read == 0) ? parser->size : read) - 1;
+          ++parser->stats.skipped;
+        }
+        break;
+
+      case UBX_STATE_CLASS:
+        UbxChecksum(parser, value);
+        parser->msg_class = value;
+        parser->state = UBX_STATE_ID;
+        break;
+
+      case UBX_STATE_ID:
+        UbxChecksum(parser, value);
+        parser->msg_id = value;
+        parser->state = UBX_STATE_LENGTH_1;
+        break;
+
+      case UBX_STATE_LENGTH_1:
+        UbxChecksum(parser, value);
+        parser->length = value;
+        parser->state = UBX_STATE_LENGTH_2;
+        break;
+
+      case UBX_STATE_LENGTH_2:
+        UbxChecksum(parser, value);
+        parser->length |= (uint16_t)(value << 8);
+        parser->count = 0;
+        parser->payload = read;
+        // The whole frame must stay in the ring until it is dispatched.
+        if (parser->length > (parser->size - UBX_OVERHEAD)) {
+          ++parser->stats.length_errors;
+          parser->state = UBX_STATE_SYNC_1;
+        } else {
+          parser->state = (parser->length > 0) ? UBX_STATE_PAYLOAD
+                                                : UBX_STATE_CK_A;
+        }
+        break;
+
+      case UBX_STATE_CK_A:
+        if (value == parser->ck_a) {
+          parser->state = UBX_STATE_CK_B;
+        } else {
+          ++parser->stats.checksum_errors;
+          parser->state = UBX_STATE_SYNC_1;
+        }
+        break;
+
+      case UBX_STATE_CK_B:
+        parser->state = UBX_STATE_SYNC_1;
+        if (value == parser->ck_b) {
+          UbxDispatch(parser);
+        } else {
+          ++parser->stats.checksum_errors;
+        }
+        break;
+
+      default:
+        parser->state = UBX_STATE_SYNC_1;
+        break;
+    }
+  }
+
+  parser->read = read;
+}
+
+uint16_t BspUbxTail(const BspUbxParser* parser) {
+  return (parser->state == UBX_STATE_SYNC_1) ? parser->read : parser->start;
+}
+
+uint8_t BspUbxU8(const BspUbxMessage* message, uint16_t offset) {
+  if (offset < message->part_length[0]) return message->part[0][offset];
+  return message->part[1][offset - message->part_length[0]];
+}
+
+uint16_t BspUbxU16(const BspUbxMessage* message, uint16_t offset) {
+  return (uint16_t)(BspUbxU8(message, offset) |
+                    (BspUbxU8(message, offset + 1) << 8));
+}
+
+uint32_t BspUbxU32(const BspUbxMessage* message, uint16_t offset) {
+  return (uint32_t)BspUbxU16(message, offset) |
+         ((uint32_t)BspUbxU16(message, offset + 2) << 16);
+}
+
+uint8_t BspUbxNavPvtDecode(const BspUbxMessage* message, BspUbxNavPvt* pvt) {
+  if ((message->msg_class != BSP_UBX_CLASS_NAV) ||
+      (message->msg_id != BSP_UBX_ID_NAV_PVT) ||
+      (message->length < BSP_UBX_NAV_PVT_LENGTH)) {
+    return 1;
+  }
+
+  // Offsets from the interface description, UBX-NAV-PVT.
+  pvt->itow = BspUbxU32(message, 0);
+  pvt->year = BspUbxU16(message, 4);
+  pvt->month = BspUbxU8(message, 6);
+  pvt->day = BspUbxU8(message, 7);
+  pvt->hour = BspUbxU8(message, 8);
+  pvt->min = BspUbxU8(message, 9);
+  pvt->sec = BspUbxU8(message, 10);
+  pvt->valid = BspUbxU8(message, 11);
+  pvt->fix_type = BspUbxU8(message, 20);
+  pvt->flags = BspUbxU8(message, 21);
+  pvt->num_sv = BspUbxU8(message, 23);
+  pvt->lon = (int32_t)BspUbxU32(message, 24);
+  pvt->lat = (int32_t)BspUbxU32(message, 28);
+  pvt->height = (int32_t)BspUbxU32(message, 32);
+  pvt->h_msl = (int32_t)BspUbxU32(message, 36);
+  pvt->h_acc = BspUbxU32(message, 40);
+  pvt->v_acc = BspUbxU32(message, 44);
+  pvt->vel_n = (int32_t)BspUbxU32(message, 48);
+  pvt->vel_e = (int32_t)BspUbxU32(message, 52);
+  pvt->vel_d = (int32_t)BspUbxU32(message, 56);
+  pvt->g_speed = (int32_t)BspUbxU32(message, 60);
+  pvt->head_mot = (int32_t)BspUbxU32(message, 64);
+  pvt->p_dop = BspUbxU16(message, 76);
+
+  return 0;
+}
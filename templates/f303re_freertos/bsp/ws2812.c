@@ -0,0 +1,188 @@
+/**
+ * @file ws2812.c
+ * @author DFlubacher
+ * @brief WS2812 driver, TIM8 PWM with DMA burst updates.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "ws2812.h"
+
+#include <stdint.h>
+
+#include "stm32f3xx.h"
+
+// 48 MHz timer clock: bit period 1.25 us, high time 0.4 us (0) / 0.8 us (1).
+#define WS2812_PERIOD 60
+#define WS2812_T0H 19
+#define WS2812_T1H 38
+
+// One byte slot per bit, the DMA widens it to the 16-bit CCR1.
+#define WS2812_SLOTS (BSP_WS2812_LEDS * 24 + BSP_WS2812_RESET_SLOTS)
+
+// DMA burst: 1 transfer to CCR1 (word offset in TIM_TypeDef).
+#define WS2812_DBA ((uint32_t)(&((TIM_TypeDef*)0)->CCR1) / 4)
+#define WS2812_DBL 0
+
+// Frame buffers, word aligned for the 4-slot table entries.
+static uint32_t ws2812_frames[2][(WS2812_SLOTS + 3) / 4];
+
+// Slots of 4 bits, MSB first, first slot in the lowest byte.
+static uint32_t ws2812_nibbles[16];
+
+// Buffer going out (or last sent), free/queued state of the other one.
+static volatile uint8_t ws2812_front;
+static volatile uint8_t ws2812_sending;
+static volatile uint8_t ws2812_queued;
+
+/**
+ * @brief Start the DMA on `frame`. The first update event loads slot 0 into
+ * the CCR1 preload, the output follows one period later.
+ */
+static void Ws2812Start(uint8_t frame) {
+  ws2812_front = frame;
+  ws2812_sending = 1;
+
+  DMA2_Channel1->CCR &= ~DMA_CCR_EN;
+  DMA2_Channel1->CMAR = (uint32_t)ws2812_frames[frame];
+  DMA2_Channel1->CNDTR = WS2812_SLOTS;
+  DMA2->IFCR = DMA_IFCR_CGIF1;
+  DMA2_Channel1->CCR |= DMA_CCR_EN;
+
+  TIM8->CNT = 0;
+  TIM8->DIER = TIM_DIER_UDE;
+  TIM8->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * @brief 4 bits to 4 slots.
+ */
+static void Ws2812Byte(uint8_t* slots, uint8_t value) {
+  uint32_t* words = (uint32_t*)slots;
+
+  words[0] = ws2812_nibbles[value >> 4];
+  words[1] = ws2812_nibbles[value & 0x0F];
+}
+
+void BspWs2812Init(void) {
+  uint8_t i;
+  uint8_t b;
+  uint32_t j;
+
+  for (i = 0; i < 16; ++i) {
+    ws2812_nibbles[i] = 0;
+    for (b = 0; b < 4; ++b) {
+      uint32_t high = ((i >> (3 - b)) & 0x01) ? WS2812_T1H : WS2812_T0H;
+      ws2812_nibbles[i] |= high << (8 * b);
+    }
+  }
+
+  // All LEDs off, reset slots low.
+  for (j = 0; j < (WS2812_SLOTS + 3) / 4; ++j) {
+    ws2812_frames[0][j] = 0;
+    ws2812_frames[1][j] = 0;
+  }
+  for (j = 0; j < BSP_WS2812_LEDS * 3; ++j) {
+    Ws2812Byte((uint8_t*)ws2812_frames[0] + 8 * j, 0);
+    Ws2812Byte((uint8_t*)ws2812_frames[1] + 8 * j, 0);
+  }
+  ws2812_front = 0;
+  ws2812_sending = 0;
+  ws2812_queued = 0;
+
+  // 1. Configure PA15.
+  // Enable port A.
+  RCC->AHBENR |= RCC_AHBENR_GPIOAEN | RCC_AHBENR_DMA2EN;
+
+  // Set PA15 to mode 'Alternate Function' (0b10), AF2 (TIM8_CH1).
+  GPIOA->MODER &= ~GPIO_MODER_MODER15_Msk;
+  GPIOA->MODER |= (0x02 << GPIO_MODER_MODER15_Pos);
+  GPIOA->AFR[1] &= ~GPIO_AFRH_AFRH7_Msk;
+  GPIOA->AFR[1] |= (0x02 << GPIO_AFRH_AFRH7_Pos);
+
+  // 2. Configure Timer 8: 48 MHz, 1.25 us period.
+  RCC->APB2ENR |= RCC_APB2ENR_TIM8EN;
+  TIM8->CR1 = 0x0000;
+  TIM8->CR2 = 0x0000;
+  TIM8->CCER = 0x0000;
+  TIM8->PSC = 0;
+  TIM8->ARR = WS2812_PERIOD - 1;
+  TIM8->RCR = 0;
+
+  // PWM mode 1 with preload: the DMA writes the compare value of the next
+  // period. CCR1 = 0 keeps the line low.
+  TIM8->CCMR1 = (0x06 << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE;
+  TIM8->CCR1 = 0;
+  TIM8->EGR = TIM_EGR_UG;
+  TIM8->CCER = TIM_CCER_CC1E;
+  TIM8->BDTR |= TIM_BDTR_MOE;
+
+  // Each update writes one slot through DMAR.
+  TIM8->DCR = (WS2812_DBL << TIM_DCR_DBL_Pos) | (WS2812_DBA << TIM_DCR_DBA_Pos);
+
+  // 3. DMA2 channel 1 (TIM8_UP): memory to peripheral, 8 to 16 bit (zero
+  // extended), transfer complete interrupt.
+  DMA2_Channel1->CCR = 0;
+  DMA2_Channel1->CPAR = (uint32_t)&TIM8->DMAR;
+  DMA2_Channel1->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PSIZE_0 |
+                       DMA_CCR_PL_1 | DMA_CCR_TCIE;
+  NVIC_SetPriority(DMA2_Channel1_IRQn, 6);
+  NVIC_EnableIRQ(DMA2_Channel1_IRQn);
+}
+
+uint8_t BspWs2812Render(const uint32_t* colors, uint16_t count) {
+  uint8_t* slots;
+  uint16_t i;
+
+  // The free buffer is the one not going out, unless it is queued.
+  if (ws2812_queued) return BSP_WS2812_ERR_BUSY;
+  slots = (uint8_t*)ws2812_frames[ws2812_front ^ 1];
+
+  if (count > BSP_WS2812_LEDS) count = BSP_WS2812_LEDS;
+  for (i = 0; i < BSP_WS2812_LEDS; ++i) {
+    uint32_t color = (i < count) ? colors[i] : 0;
+    Ws2812Byte(&slots[24 * i], (uint8_t)(color >> 8));
+    Ws2812Byte(&slots[24 * i + 8], (uint8_t)(color >> 16));
+    Ws2812Byte(&slots[24 * i + 16], (uint8_t)color);
+  }
+
+  return BSP_WS2812_OK;
+}
+
+uint8_t BspWs2812Show(void) {
+  uint32_t primask = __get_PRIMASK();
+  uint8_t status = BSP_WS2812_OK;
+
+  // Keep the transfer complete interrupt out while deciding.
+  __disable_irq();
+  if (ws2812_queued) {
+    status = BSP_WS2812_ERR_BUSY;
+  } else if (ws2812_sending) {
+    ws2812_queued = 1;
+  } else {
+    Ws2812Start(ws2812_front ^ 1);
+  }
+  __set_PRIMASK(primask);
+
+  return status;
+}
+
+uint8_t BspWs2812Busy(void) { return ws2812_sending || ws2812_queued; }
+
+void DMA2_Channel1_IRQHandler(void) {
+  if ((DMA2->ISR & DMA_ISR_TCIF1) != 0) {
+    DMA2->IFCR = DMA_IFCR_CTCIF1;
+
+    // The last slots are low reset slots, CCR1 and its preload are 0.
+    TIM8->CR1 &= ~TIM_CR1_CEN;
+    TIM8->DIER = 0x0000;
+    ws2812_sending = 0;
+
+    if (ws2812_queued) {
+      ws2812_queued = 0;
+      Ws2812Start(ws2812_front ^ 1);
+    }
+  }
+  DMA2->IFCR = DMA_IFCR_CGIF1;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file dds_bench.c
+ * @author DFlubacher
+ * @brief DDS engine (bsp/dds.c) against the exact sine, and its cost.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * 1. Tones: every sample of a few frequencies within 1 LSB of the exact sine
+ *    at the same phase, frequency error below rate / 2^32.
+ * 2. Chirp: samples within 1 LSB of the exact discrete chirp, end frequency
+ *    held afterwards.
+ * 3. Levels: full amplitude around several offsets, and the defaults after
+ *    `BspDdsInit()`, stay within 0 ... 4095.
+ * 4. Cost per sample in blocks of BSP_DAC_WAVE_SAMPLES / 2, host time. On
+ *    the target see `BspDacWaveStats.cycles_max`.
+ * Exit status is the number of failed checks.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "dac.h"
+#include "dds.h"
+
+#define RATE_HZ 48000
+#define BLOCK (BSP_DAC_WAVE_SAMPLES / 2)
+#define SECOND RATE_HZ
+#define BENCH_SAMPLES 20000000
+
+static BspDds dds;
+static uint16_t samples[SECOND];
+
+static uint64_t NowNs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void Render(uint16_t* out, uint32_t count) {
+  uint32_t n;
+
+  for (; count > 0; count -= n, out += n) {
+    n = (count < BLOCK) ? count : BLOCK;
+    BspDdsFill(out, (uint16_t)n, &dds);
+  }
+}
+
+/**
+ * @brief Largest deviation of `samples` from offset + swing * sin(2 pi
+ * phase(n)), phase in turns.
+ */
+static double MaxError(uint32_t count, double offset, double swing,
+                       double (*phase)(uint32_t n)) {
+  double error;
+  double max = 0.0;
+  uint32_t n;
+
+  for (n = 0; n < count; ++n) {
+    error = fabs(samples[n] -
+                 (offset + swing * sin(2.0 * M_PI * phase(n))));
+    if (error > max) max = error;
+  }
+  return max;
+}
+
+// Exact phase of the test signals, in turns.
+static uint32_t tone_step;
+static double chirp_start;
+static double chirp_sweep;
+
+static double TonePhase(uint32_t n) {
+  return (double)(uint32_t)(n * tone_step) / 4294967296.0;
+}
+
+static double ChirpPhase(uint32_t n) {
+  // Integer part of a Q32.32 increment per sample; the fractional part only
+  // carries the sweep.
+  double turns = 0.0;
+  uint32_t k;
+
+  for (k = 0; k < n; ++k) {
+    turns += floor(chirp_start + chirp_sweep * k) / 4294967296.0;
+  }
+  return turns - floor(turns);
+}
+
+// Swing of full amplitude at mid-scale (gain limited to 32760, Q15 sine).
+static double Swing(void) {
+  return 32767.0 * dds.active.gain / 524288.0;
+}
+
+static uint32_t CheckTones(void) {
+  static const float frequencies[] = {1.0f, 1000.25f, 12345.678f, 23999.0f};
+  uint32_t failures = 0;
+  double frequency;
+  double error;
+  uint8_t i;
+
+  for (i = 0; i < sizeof(frequencies) / sizeof(frequencies[0]); ++i) {
+    BspDdsInit(&dds, RATE_HZ);
+    BspDdsSetTone(&dds, frequencies[i]);
+    BspDdsSetAmplitude(&dds, 65536, 2048);
+    Render(samples, SECOND);
+
+    tone_step = (uint32_t)(dds.active.increment >> 32);
+    frequency = tone_step * (double)RATE_HZ / 4294967296.0;
+    error = MaxError(SECOND, 2048.0, Swing(), TonePhase);
+    printf("tone %10.3f Hz: actual %.6f Hz, max error %.2f LSB\n",
+           frequencies[i], frequency, error);
+    if ((error > 1.0) ||
+        (fabs(frequency - frequencies[i]) > RATE_HZ / 4294967296.0 +
+                                                frequencies[i] * 1e-7)) {
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+static uint32_t CheckChirp(void) {
+  const uint32_t length = SECOND / 4;
+  uint32_t failures = 0;
+  double end_hz;
+  double error;
+
+  BspDdsInit(&dds, RATE_HZ);
+  BspDdsSetChirp(&dds, 100.0f, 10000.0f, 0.25f, 0);
+  Render(samples, length);
+
+  chirp_start = (double)dds.pending.start / 4294967296.0;
+  chirp_sweep = (double)dds.pending.sweep / 4294967296.0;
+  error = MaxError(length, 2048.0, Swing(), ChirpPhase);
+
+  // Past the end the frequency holds.
+  Render(samples, BLOCK);
+  end_hz = (double)(dds.active.increment >> 32) * RATE_HZ / 4294967296.0;
+  printf("chirp 100 ... 10000 Hz in 0.25 s: max error %.2f LSB, end %.4f Hz\n",
+         error, end_hz);
+  if ((error > 1.0) || (fabs(end_hz - 10000.0) > 0.01) ||
+      (dds.active.sweep != 0)) {
+    ++failures;
+  }
+  return failures;
+}
+
+/**
+ * @brief Render one second of a 997 Hz tone (1000.5 Hz with the defaults)
+ * and check its range around `offset`.
+ */
+static uint32_t CheckLevel(uint8_t defaults, uint16_t offset) {
+  uint16_t low = 0xFFFF;
+  uint16_t high = 0;
+  uint32_t n;
+
+  BspDdsInit(&dds, RATE_HZ);
+  if (defaults) {
+    BspDdsSetTone(&dds, 1000.5f);
+  } else {
+    BspDdsSetTone(&dds, 997.0f);
+    BspDdsSetAmplitude(&dds, 65536, offset);
+  }
+  Render(samples, SECOND);
+  for (n = 0; n < SECOND; ++n) {
+    if (samples[n] < low) low = samples[n];
+    if (samples[n] > high) high = samples[n];
+  }
+  printf("%-8s %4u: %4u ... %4u\n", defaults ? "defaults" : "offset",
+         offset, low, high);
+  return (high > 4095) || (low > offset) || (high < offset);
+}
+
+static uint32_t CheckLevels(void) {
+  static const uint16_t offsets[] = {0, 1, 100, 2047, 2048, 4000, 4095};
+  uint32_t failures = 0;
+  uint8_t i;
+
+  for (i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+    failures += CheckLevel(0, offsets[i]);
+  }
+  // The header example: no `BspDdsSetAmplitude()`.
+  failures += CheckLevel(1, 2048);
+  return failures;
+}
+
+static double Cost(uint8_t chirp) {
+  uint64_t start;
+  uint32_t n;
+
+  BspDdsInit(&dds, RATE_HZ);
+  if (chirp) {
+    BspDdsSetChirp(&dds, 20.0f, 20000.0f, 1.0f, 1);
+  } else {
+    BspDdsSetTone(&dds, 1000.25f);
+  }
+  start = NowNs();
+  for (n = 0; n < BENCH_SAMPLES; n += BLOCK) {
+    BspDdsFill(samples, BLOCK, &dds);
+  }
+  return (double)(NowNs() - start) / BENCH_SAMPLES;
+}
+
+int main(void) {
+  uint32_t failures = 0;
+
+  failures += CheckTones();
+  failures += CheckChirp();
+  failures += CheckLevels();
+  printf("cost: tone %.2f ns/sample, chirp %.2f ns/sample (host)\n", Cost(0),
+         Cost(1));
+  printf("%u failures\n", failures);
+  return (int)failures;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file i2c_bench.c
+ * @author DFlubacher
+ * @brief Run the I2C1 driver (bsp/comms.c) against simulated devices: check
+ * the transferred data and error codes, report cost per transaction.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Usage: i2c_bench [iterations]
+ * Exit status is the number of failed scenarios.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "comms.h"
+#include "sim.h"
+#include "sim_i2c.h"
+
+#define EEPROM_ADDRESS 0x50
+#define EEPROM_SIZE 4096
+#define BMP390_ADDRESS 0x77
+#define UNUSED_ADDRESS 0x42
+
+static uint8_t eeprom_memory[EEPROM_SIZE];
+static SimRegFile eeprom;
+static SimBmp390 barometer;
+
+static uint8_t buffer[1024];
+static uint8_t pattern[1024];
+
+typedef uint8_t (*Scenario)(void);
+
+static uint64_t NowNs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// ===   Scenarios, return 0 on success   =====================================
+
+static uint8_t BarometerChipId(void) {
+  buffer[0] = 0;
+  if (BspI2C1_Read(BMP390_ADDRESS, 0x00, buffer, 1) != BSP_I2C_OK) return 1;
+  return buffer[0] != 0x60;
+}
+
+static uint8_t BarometerData(void) {
+  uint8_t mode = 0x33;
+
+  // Normal mode, then read pressure and temperature in one burst.
+  if (BspI2C1_Write(BMP390_ADDRESS, 0x1B, &mode, 1) != BSP_I2C_OK) return 1;
+  if (BspI2C1_Read(BMP390_ADDRESS, 0x04, buffer, 6) != BSP_I2C_OK) return 1;
+  return (buffer[2] != (uint8_t)(barometer.raw_pressure >> 16));
+}
+
+/**
+ * @brief 2-byte address and 32 bytes payload in one transfer.
+ *
+ * @return uint8_t driver result.
+ */
+static uint8_t EepromWrite(void) {
+  uint8_t address[2] = {0x01, 0x00};
+  BspI2cSegment segments[2] = {
+      {address, 2, BSP_I2C_SEG_WRITE},
+      {pattern, 32, BSP_I2C_SEG_WRITE},
+  };
+  BspI2cTransaction transaction = {EEPROM_ADDRESS, segments, 2};
+
+  memset(&eeprom_memory[0x100], 0, 32);
+  return BspI2C1_Transfer(&transaction);
+}
+
+/**
+ * @brief 2-byte address, repeated START, read `length`.
+ *
+ * @return uint8_t driver result.
+ */
+static uint8_t EepromRandomRead(uint16_t length) {
+  uint8_t address[2] = {0x02, 0x00};
+  BspI2cSegment segments[2] = {
+      {address, 2, BSP_I2C_SEG_WRITE},
+      {buffer, length, BSP_I2C_SEG_READ | BSP_I2C_SEG_RESTART},
+  };
+  BspI2cTransaction transaction = {EEPROM_ADDRESS, segments, 2};
+
+  memcpy(&eeprom_memory[0x200], pattern, length);
+  memset(buffer, 0, length);
+  return BspI2C1_Transfer(&transaction);
+}
+
+static uint8_t EepromWrite32(void) {
+  if (EepromWrite() != BSP_I2C_OK) return 1;
+  return memcmp(&eeprom_memory[0x100], pattern, 32) != 0;
+}
+
+static uint8_t EepromRead16(void) {
+  if (EepromRandomRead(16) != BSP_I2C_OK) return 1;
+  return memcmp(buffer, pattern, 16) != 0;
+}
+
+// NBYTES reload (TCR) path.
+static uint8_t EepromRead600(void) {
+  if (EepromRandomRead(600) != BSP_I2C_OK) return 1;
+  return memcmp(buffer, pattern, 600) != 0;
+}
+
+static uint8_t NackAddress(void) {
+  return BspI2C1_Read(UNUSED_ADDRESS, 0x00, buffer, 1) !=
+         BSP_I2C_ERR_ADDRESS;
+}
+
+static uint8_t NackData(void) {
+  uint8_t result;
+
+  // Address bytes are accepted, the first payload byte is not.
+  eeprom.device.nack_write = eeprom.device.writes + 3;
+  result = EepromWrite();
+  eeprom.device.nack_write = 0;
+  return (result != BSP_I2C_ERR_WRITE);
+}
+
+static uint8_t NackRestart(void) {
+  uint8_t result;
+
+  // NACK the address after the repeated START.
+  eeprom.device.nack_start = eeprom.device.starts + 2;
+  result = EepromRandomRead(16);
+  eeprom.device.nack_start = 0;
+  return (result != BSP_I2C_ERR_READ);
+}
+
+static uint8_t Stretched(void) {
+  uint8_t result;
+
+  eeprom.device.stretch_polls = 20;
+  result = EepromRead16();
+  eeprom.device.stretch_polls = 0;
+  return result;
+}
+
+// ===   Runner   =============================================================
+
+typedef struct {
+  const char* name;
+  Scenario run;
+  uint32_t payload;
+} BenchCase;
+
+static const BenchCase cases[] = {
+    {"bmp390 chip id", BarometerChipId, 1},
+    {"bmp390 data (6)", BarometerData, 6},
+    {"eeprom write (2+32)", EepromWrite32, 32},
+    {"eeprom random read (16)", EepromRead16, 16},
+    {"eeprom random read (600)", EepromRead600, 600},
+    {"nack address", NackAddress, 0},
+    {"nack data", NackData, 0},
+    {"nack repeated start", NackRestart, 0},
+    {"stretched read (16)", Stretched, 16},
+};
+
+int main(int argc, char** argv) {
+  uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 100;
+  uint32_t failures = 0;
+  uint32_t i;
+  uint32_t n;
+
+  for (i = 0; i < sizeof(pattern); ++i) pattern[i] = (uint8_t)(i * 7 + 3);
+  if (iterations == 0) iterations = 1;
+
+  SimI2cInit();
+  SimRegFileInit(&eeprom, EEPROM_ADDRESS, eeprom_memory, EEPROM_SIZE, 2);
+  SimBmp390Init(&barometer, BMP390_ADDRESS);
+  SimI2cAttach(&eeprom.device);
+  SimI2cAttach(&barometer.regfile.device);
+  SimArm();
+
+  BspI2C1_Init();
+
+  printf("%-26s %6s %9s %8s %10s %10s %10s\n", "scenario", "result",
+         "accesses", "polls", "bus [us]", "bus kB/s", "host [us]");
+
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    SimI2cStats stats;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t failed = 0;
+
+    SimI2cResetStats();
+    start = NowNs();
+    for (n = 0; n < iterations; ++n) failed += cases[i].run();
+    elapsed = NowNs() - start;
+    SimI2cGetStats(&stats);
+
+    failures += (failed != 0);
+    printf("%-26s %6s %9.1f %8.1f %10.1f %10.1f %10.2f\n", cases[i].name,
+           failed ? "FAIL" : "ok", (double)stats.accesses / iterations,
+           (double)stats.status_polls / iterations,
+           stats.bus_time_ns / 1000.0 / iterations,
+           stats.bus_time_ns ? (double)cases[i].payload * iterations * 1e6 /
+                                   stats.bus_time_ns
+                             : 0.0,
+           elapsed / 1000.0 / iterations);
+  }
+
+  return (int)failures;
+}
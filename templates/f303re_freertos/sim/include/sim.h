@@ -0,0 +1,77 @@
+/**
+ * @file sim.h
+ * @author DFlubacher
+ * @brief Host-side peripheral simulation (Linux, x86-64).
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Peripheral register blocks are mapped at their real addresses, so the BSP
+ * sources compile and run unmodified against the CMSIS device header.
+ *
+ * Plain blocks (RCC, GPIO, ...) are ordinary memory. Simulated blocks are
+ * mapped without access rights: every register access faults, the access is
+ * reported to the model (pre hook), the instruction is single-stepped with
+ * access granted and the model sees the result (post hook). Reads and writes
+ * are distinguished by the page fault error code.
+ *
+ */
+
+#ifndef SIM_INCLUDE_SIM_H_
+#define SIM_INCLUDE_SIM_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Register access notification.
+ *
+ * @param offset byte offset of the access within the block.
+ * @param is_write 1 for a write (or read-modify-write), 0 for a read.
+ * @param context
+ */
+typedef void (*SimAccessHook)(uint32_t offset, uint8_t is_write,
+                              void* context);
+
+/**
+ * @brief Install the fault handlers. Called by the Map functions.
+ */
+void SimInit(void);
+
+/**
+ * @brief Map zero-initialized plain memory at the peripheral address `base`.
+ * The range is rounded to page boundaries, mapping twice is harmless.
+ *
+ * @param base
+ * @param size
+ */
+void SimMapMemory(uintptr_t base, uint32_t size);
+
+/**
+ * @brief Map a simulated register block at `base`. `pre` runs before the
+ * access (e.g. to advance time on a status poll), `post` after it (e.g. to
+ * consume a written data register). The block must not share a page with
+ * another mapping. Returns the block, accessible from within the hooks and
+ * before the first access only.
+ *
+ * @param base
+ * @param pre may be NULL.
+ * @param post may be NULL.
+ * @param context
+ * @return volatile void*
+ */
+volatile void* SimMapPeripheral(uintptr_t base, SimAccessHook pre,
+                                SimAccessHook post, void* context);
+
+/**
+ * @brief Revoke access to all simulated blocks. Call after initializing the
+ * register contents.
+ */
+void SimArm(void);
+
+/**
+ * @brief Number of trapped register accesses since start.
+ *
+ * @return uint64_t
+ */
+uint64_t SimAccessCount(void);
+
+#endif /* SIM_INCLUDE_SIM_H_ */
@@ -0,0 +1,66 @@
+/**
+ * @file sim_flash.h
+ * @author DFlubacher
+ * @brief NOR flash model in RAM with simulated program/erase times.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Erase sets a sector to 0xFF, program can only clear bits (AND). Programming
+ * a bit from 0 to 1, accessing the flash while busy or crossing a page are
+ * counted as violations. Time advances with `SimFlashTick()`.
+ *
+ */
+
+#ifndef SIM_INCLUDE_SIM_FLASH_H_
+#define SIM_INCLUDE_SIM_FLASH_H_
+
+#include <stdint.h>
+
+#include "log_store.h"
+
+typedef struct {
+  uint8_t* memory;
+  uint32_t size;
+  uint32_t sector_size;
+  uint32_t page_size;
+  // Busy times in us. Erase times are drawn between typical and worst case.
+  uint32_t program_us;
+  uint32_t erase_typical_us;
+  uint32_t erase_worst_us;
+
+  // Maintained by the model.
+  uint64_t now_us;
+  uint64_t busy_until_us;
+  uint32_t programs;
+  uint32_t erases;
+  uint32_t reads;
+  uint32_t violations;
+} SimFlash;
+
+/**
+ * @brief Erased flash of `size` bytes, W25Q-like timing (page program 1 ms,
+ * sector erase 45 ms typical, 400 ms worst case).
+ *
+ * @param flash
+ * @param memory `size` bytes.
+ * @param size
+ */
+void SimFlashInit(SimFlash* flash, uint8_t* memory, uint32_t size);
+
+/**
+ * @brief Advance the simulated time.
+ *
+ * @param flash
+ * @param us
+ */
+void SimFlashTick(SimFlash* flash, uint32_t us);
+
+/**
+ * @brief Log store backend operating on `flash`.
+ *
+ * @param flash
+ * @param log
+ */
+void SimFlashLog(SimFlash* flash, BspLogFlash* log);
+
+#endif /* SIM_INCLUDE_SIM_FLASH_H_ */
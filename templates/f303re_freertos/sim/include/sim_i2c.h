@@ -0,0 +1,116 @@
+/**
+ * @file sim_i2c.h
+ * @author DFlubacher
+ * @brief Simulated I2C1 controller with pluggable target device models.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The model reproduces the STM32F3 I2C master sequencing seen by the driver:
+ * TXIS/RXNE per byte, TC/TCR at the end of an NBYTES chunk, NACKF with
+ * automatic STOP, STOPF, and the ICR/TXE flush semantics.
+ *
+ */
+
+#ifndef SIM_INCLUDE_SIM_I2C_H_
+#define SIM_INCLUDE_SIM_I2C_H_
+
+#include <stdint.h>
+
+// I2C kernel clock assumed for bus timing (SYSCLK, see BspI2C1_Init).
+#define SIM_I2C_CLOCK_HZ 48000000ULL
+
+#define SIM_I2C_MAX_DEVICES 8
+
+typedef struct SimI2cDevice SimI2cDevice;
+
+/**
+ * @brief Target device on the simulated bus. Callbacks may be NULL.
+ * `start`/`write` return 0 to acknowledge, anything else NACKs.
+ */
+struct SimI2cDevice {
+  uint8_t address;
+  uint8_t (*start)(SimI2cDevice* device, uint8_t read);
+  uint8_t (*write)(SimI2cDevice* device, uint8_t value);
+  uint8_t (*read)(SimI2cDevice* device);
+  void (*stop)(SimI2cDevice* device);
+
+  // Fault injection.
+  // NACK the address of the n-th START/RESTART (1-based), 0: never.
+  uint32_t nack_start;
+  // NACK the n-th byte written to the device (1-based), 0: never.
+  uint32_t nack_write;
+  // Clock stretching: status polls before a byte completes.
+  uint32_t stretch_polls;
+
+  // Maintained by the bus.
+  uint32_t starts;
+  uint32_t writes;
+};
+
+typedef struct {
+  // Register accesses by the driver.
+  uint64_t accesses;
+  // Reads of I2C1_ISR.
+  uint64_t status_polls;
+  uint32_t starts;
+  uint32_t stops;
+  uint32_t bytes;
+  uint32_t nacks;
+  // Time on the bus from SCL timing in TIMINGR.
+  uint64_t bus_time_ns;
+} SimI2cStats;
+
+/**
+ * @brief Map I2C1 (simulated) and the RCC/GPIO/NVIC blocks touched by the
+ * driver (plain memory). Call SimArm() after attaching the devices.
+ */
+void SimI2cInit(void);
+
+/**
+ * @brief Attach a target device to the bus.
+ *
+ * @param device
+ */
+void SimI2cAttach(SimI2cDevice* device);
+
+void SimI2cGetStats(SimI2cStats* stats);
+void SimI2cResetStats(void);
+
+// ////////////////////////////////////////////////////////////////////////////
+// Device models
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Generic register file / EEPROM: `address_bytes` pointer bytes
+ * (MSB first) after a write START, then data. Auto-incrementing pointer,
+ * wrapping at `size`.
+ */
+typedef struct {
+  SimI2cDevice device;
+  uint8_t* memory;
+  uint32_t size;
+  uint8_t address_bytes;
+  uint8_t address_left;
+  uint32_t pointer;
+  uint32_t pointer_next;
+} SimRegFile;
+
+void SimRegFileInit(SimRegFile* regfile, uint8_t address, uint8_t* memory,
+                    uint32_t size, uint8_t address_bytes);
+
+/**
+ * @brief BMP390-like barometer: chip ID, calibration NVM, power control,
+ * soft reset. A new pressure/temperature sample is latched into the data
+ * registers at each read transaction while not in sleep mode.
+ */
+typedef struct {
+  SimRegFile regfile;
+  uint8_t registers[128];
+  uint32_t raw_pressure;
+  uint32_t raw_temperature;
+  uint32_t samples;
+} SimBmp390;
+
+void SimBmp390Init(SimBmp390* sensor, uint8_t address);
+
+#endif /* SIM_INCLUDE_SIM_I2C_H_ */
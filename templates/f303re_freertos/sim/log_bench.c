@@ -0,0 +1,190 @@
+/**
+ * @file log_bench.c
+ * @author DFlubacher
+ * @brief Run the log store (bsp/log_store.c) on the simulated NOR flash.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Scenarios, 1 ms steps with the service called every step:
+ * - steady: 200 records/s for several wraps of the ring, no record may be
+ *   dropped. Read back, remount, append and read back again.
+ * - overload: 5000 records/s, drops are expected and counted, the records
+ *   read back must still be in order.
+ * Exit status is the number of failed checks.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_store.h"
+#include "sim_flash.h"
+
+#define FLASH_SIZE (64 * 1024)
+#define RECORD_SIZE 16
+
+static uint8_t memory[FLASH_SIZE];
+static SimFlash flash;
+static BspLogFlash log_flash;
+static BspLogStore store;
+
+// Record counter of the producer, one per attempt.
+static uint32_t counter;
+static uint32_t failures;
+
+static void Check(uint8_t ok, const char* what) {
+  printf("  %-44s %s\n", what, ok ? "ok" : "FAIL");
+  if (!ok) ++failures;
+}
+
+/**
+ * @brief Records are the counter and a pattern derived from it.
+ */
+static uint8_t Append(void) {
+  uint8_t record[RECORD_SIZE];
+  uint32_t i;
+
+  memcpy(record, &counter, sizeof(counter));
+  for (i = sizeof(counter); i < RECORD_SIZE; ++i) {
+    record[i] = (uint8_t)(counter * 7 + i);
+  }
+  ++counter;
+  return BspLogAppend(&store, record, RECORD_SIZE);
+}
+
+/**
+ * @brief `ms` steps of 1 ms with `per_second` records/s.
+ */
+static void Run(uint32_t ms, uint32_t per_second) {
+  uint64_t due = 0;
+  uint32_t t;
+
+  for (t = 0; t < ms; ++t) {
+    due += per_second;
+    while (due >= 1000) {
+      due -= 1000;
+      Append();
+    }
+    BspLogService(&store);
+    SimFlashTick(&flash, 1000);
+  }
+}
+
+/**
+ * @brief Flush and service until everything is programmed.
+ */
+static void Drain(void) {
+  BspLogFlush(&store);
+  while ((BspLogService(&store) > 0) || log_flash.busy(log_flash.context)) {
+    SimFlashTick(&flash, 1000);
+  }
+}
+
+/**
+ * @brief Read all records, check their content and order.
+ *
+ * @param contiguous no gaps allowed between the counters.
+ * @param first first counter read.
+ * @param last last counter read.
+ * @return uint32_t records read, 0 on any error.
+ */
+static uint32_t ReadBack(uint8_t contiguous, uint32_t* first, uint32_t* last) {
+  BspLogCursor cursor;
+  uint8_t record[RECORD_SIZE];
+  uint16_t length;
+  uint32_t value;
+  uint32_t n = 0;
+  uint32_t i;
+
+  BspLogReadBegin(&store, &cursor);
+  while (BspLogReadNext(&store, &cursor, record, sizeof(record), &length) ==
+         BSP_LOG_OK) {
+    if (length != RECORD_SIZE) return 0;
+    memcpy(&value, record, sizeof(value));
+    for (i = sizeof(value); i < RECORD_SIZE; ++i) {
+      if (record[i] != (uint8_t)(value * 7 + i)) return 0;
+    }
+    if (n == 0) {
+      *first = value;
+    } else if ((value <= *last) || (contiguous && (value != (*last + 1)))) {
+      return 0;
+    }
+    *last = value;
+    ++n;
+  }
+  return n;
+}
+
+static void PrintStats(void) {
+  const BspLogStats* stats = &store.stats;
+
+  printf("  records %u dropped %u pages %u erases %u overwritten %u"
+         " buffers peak %u/%u\n",
+         stats->records, stats->dropped, stats->pages_programmed,
+         stats->sectors_erased, stats->pages_overwritten, stats->buffers_peak,
+         BSP_LOG_BUFFERS);
+  printf("  flash: programs %u erases %u violations %u\n", flash.programs,
+         flash.erases, flash.violations);
+}
+
+static void Start(void) {
+  SimFlashInit(&flash, memory, FLASH_SIZE);
+  SimFlashLog(&flash, &log_flash);
+  counter = 0;
+  srand(1);
+  BspLogMount(&store, &log_flash);
+}
+
+int main(void) {
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint32_t n;
+  uint32_t pages;
+  uint32_t previous;
+
+  // ===   Steady rate   =======================================================
+  printf("steady, 200 records/s, %u KB flash\n", FLASH_SIZE / 1024);
+  Start();
+  // About 6 wraps of the ring.
+  Run(120000, 200);
+  Drain();
+  PrintStats();
+  Check(store.stats.dropped == 0, "no record dropped");
+  Check(store.stats.pages_overwritten > 0, "ring wrapped");
+  Check((flash.violations == 0) && (store.stats.flash_errors == 0),
+        "no flash violations");
+  n = ReadBack(1, &first, &last);
+  printf("  read %u records, %u ... %u\n", n, first, last);
+  Check((n > 0) && (last == counter - 1), "read back in order to the last");
+
+  // Power cycle: a new store on the same flash.
+  pages = store.pages;
+  BspLogMount(&store, &log_flash);
+  Check(store.pages == pages, "remount finds all pages");
+  previous = last;
+  Check((ReadBack(1, &first, &last) == n) && (last == previous),
+        "remount reads the same records");
+  Run(30000, 200);
+  Drain();
+  Check((ReadBack(1, &first, &last) > 0) && (last == counter - 1) &&
+            (store.stats.dropped == 0) && (flash.violations == 0),
+        "append after remount continues");
+
+  // ===   Overload   ==========================================================
+  printf("overload, 5000 records/s\n");
+  Start();
+  Run(60000, 5000);
+  Drain();
+  PrintStats();
+  Check(store.stats.dropped > 0, "drops counted");
+  Check(store.stats.records + store.stats.dropped == counter,
+        "records + dropped = attempts");
+  Check(flash.violations == 0, "no flash violations");
+  n = ReadBack(0, &first, &last);
+  printf("  read %u records, %u ... %u\n", n, first, last);
+  Check(n > 0, "read back in order");
+
+  return (int)failures;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file bmp390.c
+ * @author DFlubacher
+ * @brief BMP390-like barometer device model (I2C interface).
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sim_i2c.h"
+
+#define BMP390_CHIP_ID 0x00
+#define BMP390_REV_ID 0x01
+#define BMP390_STATUS 0x03
+#define BMP390_DATA_0 0x04
+#define BMP390_SENSORTIME_0 0x0C
+#define BMP390_PWR_CTRL 0x1B
+#define BMP390_OSR 0x1C
+#define BMP390_CALIB_DATA 0x31
+#define BMP390_CMD 0x7E
+
+#define BMP390_STATUS_CMD_RDY 0x10
+#define BMP390_STATUS_DRDY_PRESS 0x20
+#define BMP390_STATUS_DRDY_TEMP 0x40
+#define BMP390_PWR_CTRL_MODE_Msk 0x30
+#define BMP390_CMD_SOFTRESET 0xB6
+
+// Representative calibration NVM (0x31..0x45), little endian.
+static const uint8_t bmp390_calibration[21] = {
+    0x98, 0x6A,  // NVM_PAR_T1
+    0x8C, 0x48,  // NVM_PAR_T2
+    0xF9,        // NVM_PAR_T3
+    0x8C, 0xFB,  // NVM_PAR_P1
+    0x5A, 0xF2,  // NVM_PAR_P2
+    0x23,        // NVM_PAR_P3
+    0x01,        // NVM_PAR_P4
+    0x0D, 0x60,  // NVM_PAR_P5
+    0x83, 0x74,  // NVM_PAR_P6
+    0x03,        // NVM_PAR_P7
+    0xFA,        // NVM_PAR_P8
+    0xA3, 0x0D,  // NVM_PAR_P9
+    0x04,        // NVM_PAR_P10
+    0xC4,        // NVM_PAR_P11
+};
+
+static void Bmp390Reset(SimBmp390* sensor) {
+  memset(sensor->registers, 0, sizeof(sensor->registers));
+  sensor->registers[BMP390_CHIP_ID] = 0x60;
+  sensor->registers[BMP390_REV_ID] = 0x01;
+  sensor->registers[BMP390_STATUS] = BMP390_STATUS_CMD_RDY;
+  sensor->registers[BMP390_OSR] = 0x02;
+  memcpy(&sensor->registers[BMP390_CALIB_DATA], bmp390_calibration,
+         sizeof(bmp390_calibration));
+}
+
+/**
+ * @brief Latch a new conversion into the data registers.
+ */
+static void Bmp390Convert(SimBmp390* sensor) {
+  uint8_t* data = &sensor->registers[BMP390_DATA_0];
+  uint32_t pressure = sensor->raw_pressure + (sensor->samples & 0x0F);
+  uint32_t temperature = sensor->raw_temperature + (sensor->samples & 0x03);
+  uint32_t sensortime = sensor->samples * 128;
+
+  data[0] = (uint8_t)pressure;
+  data[1] = (uint8_t)(pressure >> 8);
+  data[2] = (uint8_t)(pressure >> 16);
+  data[3] = (uint8_t)temperature;
+  data[4] = (uint8_t)(temperature >> 8);
+  data[5] = (uint8_t)(temperature >> 16);
+  sensor->registers[BMP390_SENSORTIME_0] = (uint8_t)sensortime;
+  sensor->registers[BMP390_SENSORTIME_0 + 1] = (uint8_t)(sensortime >> 8);
+  sensor->registers[BMP390_SENSORTIME_0 + 2] = (uint8_t)(sensortime >> 16);
+  sensor->registers[BMP390_STATUS] |=
+      (BMP390_STATUS_DRDY_PRESS | BMP390_STATUS_DRDY_TEMP);
+  ++sensor->samples;
+
+  // Forced mode (0b01/0b10) goes back to sleep after one conversion.
+  if ((sensor->registers[BMP390_PWR_CTRL] & BMP390_PWR_CTRL_MODE_Msk) !=
+      BMP390_PWR_CTRL_MODE_Msk) {
+    sensor->registers[BMP390_PWR_CTRL] &= ~BMP390_PWR_CTRL_MODE_Msk;
+  }
+}
+
+static uint8_t Bmp390Start(SimI2cDevice* device, uint8_t read) {
+  SimBmp390* sensor = (SimBmp390*)device;
+
+  if (read &&
+      ((sensor->registers[BMP390_PWR_CTRL] & BMP390_PWR_CTRL_MODE_Msk) != 0)) {
+    Bmp390Convert(sensor);
+  }
+  sensor->regfile.address_left = read ? 0 : 1;
+  return 0;
+}
+
+static uint8_t Bmp390Write(SimI2cDevice* device, uint8_t value) {
+  SimBmp390* sensor = (SimBmp390*)device;
+  SimRegFile* regfile = &sensor->regfile;
+  uint32_t reg = regfile->pointer;
+
+  if (regfile->address_left > 0) {
+    regfile->address_left = 0;
+    regfile->pointer = value & 0x7F;
+    return 0;
+  }
+
+  // Configuration registers are writable, the rest is read-only.
+  if ((reg == BMP390_CMD) && (value == BMP390_CMD_SOFTRESET)) {
+    Bmp390Reset(sensor);
+  } else if (reg >= BMP390_PWR_CTRL && reg < BMP390_CALIB_DATA) {
+    sensor->registers[reg] = value;
+  }
+  regfile->pointer = (regfile->pointer + 1) & 0x7F;
+  return 0;
+}
+
+static uint8_t Bmp390Read(SimI2cDevice* device) {
+  SimBmp390* sensor = (SimBmp390*)device;
+  SimRegFile* regfile = &sensor->regfile;
+  uint8_t value = sensor->registers[regfile->pointer];
+
+  if (regfile->pointer == BMP390_STATUS) {
+    sensor->registers[BMP390_STATUS] &=
+        ~(BMP390_STATUS_DRDY_PRESS | BMP390_STATUS_DRDY_TEMP);
+  }
+  regfile->pointer = (regfile->pointer + 1) & 0x7F;
+  return value;
+}
+
+void SimBmp390Init(SimBmp390* sensor, uint8_t address) {
+  SimRegFileInit(&sensor->regfile, address, sensor->registers,
+                 sizeof(sensor->registers), 1);
+  sensor->regfile.device.start = Bmp390Start;
+  sensor->regfile.device.write = Bmp390Write;
+  sensor->regfile.device.read = Bmp390Read;
+
+  // Raw conversion results, varied slightly per sample.
+  sensor->raw_pressure = 6602752;
+  sensor->raw_temperature = 8651264;
+  sensor->samples = 0;
+  Bmp390Reset(sensor);
+}
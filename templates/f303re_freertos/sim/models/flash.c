@@ -0,0 +1,99 @@
+/**
+ * @file flash.c
+ * @author DFlubacher
+ * @brief NOR flash device model.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_store.h"
+#include "sim_flash.h"
+
+static uint8_t FlashBusy(void* context) {
+  SimFlash* flash = (SimFlash*)context;
+  return flash->now_us < flash->busy_until_us;
+}
+
+static uint8_t FlashRead(void* context, uint32_t address, uint8_t* data,
+                         uint32_t length) {
+  SimFlash* flash = (SimFlash*)context;
+
+  if (FlashBusy(flash) || ((address + length) > flash->size)) {
+    ++flash->violations;
+    return 1;
+  }
+  memcpy(data, &flash->memory[address], length);
+  ++flash->reads;
+  return 0;
+}
+
+static uint8_t FlashProgram(void* context, uint32_t address,
+                            const uint8_t* data, uint32_t length) {
+  SimFlash* flash = (SimFlash*)context;
+  uint32_t i;
+
+  if (FlashBusy(flash) ||
+      (((address % flash->page_size) + length) > flash->page_size) ||
+      ((address + length) > flash->size)) {
+    ++flash->violations;
+    return 1;
+  }
+
+  for (i = 0; i < length; ++i) {
+    // Programming can not set bits.
+    if ((data[i] & ~flash->memory[address + i]) != 0) ++flash->violations;
+    flash->memory[address + i] &= data[i];
+  }
+  flash->busy_until_us = flash->now_us + flash->program_us;
+  ++flash->programs;
+  return 0;
+}
+
+static uint8_t FlashErase(void* context, uint32_t address) {
+  SimFlash* flash = (SimFlash*)context;
+  uint32_t span = flash->erase_worst_us - flash->erase_typical_us;
+
+  if (FlashBusy(flash) || (address >= flash->size)) {
+    ++flash->violations;
+    return 1;
+  }
+
+  address -= address % flash->sector_size;
+  memset(&flash->memory[address], 0xFF, flash->sector_size);
+  // Mostly typical, one erase in 16 takes up to the worst case.
+  flash->busy_until_us = flash->now_us + flash->erase_typical_us;
+  if ((rand() % 16) == 0) {
+    flash->busy_until_us += (uint32_t)rand() % (span + 1);
+  }
+  ++flash->erases;
+  return 0;
+}
+
+void SimFlashInit(SimFlash* flash, uint8_t* memory, uint32_t size) {
+  memset(flash, 0, sizeof(*flash));
+  flash->memory = memory;
+  flash->size = size;
+  flash->sector_size = 4096;
+  flash->page_size = 256;
+  flash->program_us = 1000;
+  flash->erase_typical_us = 45000;
+  flash->erase_worst_us = 400000;
+  memset(memory, 0xFF, size);
+}
+
+void SimFlashTick(SimFlash* flash, uint32_t us) { flash->now_us += us; }
+
+void SimFlashLog(SimFlash* flash, BspLogFlash* log) {
+  log->read = FlashRead;
+  log->program = FlashProgram;
+  log->erase = FlashErase;
+  log->busy = FlashBusy;
+  log->context = flash;
+  log->size = flash->size;
+  log->sector_size = flash->sector_size;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file regfile.c
+ * @author DFlubacher
+ * @brief Generic register file / EEPROM device model.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include <stdint.h>
+
+#include "sim_i2c.h"
+
+static uint8_t RegFileStart(SimI2cDevice* device, uint8_t read) {
+  SimRegFile* regfile = (SimRegFile*)device;
+
+  // A write starts with the register pointer, a read continues.
+  if (!read) {
+    regfile->address_left = regfile->address_bytes;
+    regfile->pointer_next = 0;
+  }
+  return 0;
+}
+
+static uint8_t RegFileWrite(SimI2cDevice* device, uint8_t value) {
+  SimRegFile* regfile = (SimRegFile*)device;
+
+  if (regfile->address_left > 0) {
+    regfile->pointer_next = (regfile->pointer_next << 8) | value;
+    if (--regfile->address_left == 0) {
+      regfile->pointer = regfile->pointer_next % regfile->size;
+    }
+    return 0;
+  }
+
+  regfile->memory[regfile->pointer] = value;
+  regfile->pointer = (regfile->pointer + 1) % regfile->size;
+  return 0;
+}
+
+static uint8_t RegFileRead(SimI2cDevice* device) {
+  SimRegFile* regfile = (SimRegFile*)device;
+  uint8_t value = regfile->memory[regfile->pointer];
+
+  regfile->pointer = (regfile->pointer + 1) % regfile->size;
+  return value;
+}
+
+void SimRegFileInit(SimRegFile* regfile, uint8_t address, uint8_t* memory,
+                    uint32_t size, uint8_t address_bytes) {
+  SimI2cDevice* device = &regfile->device;
+
+  device->address = address;
+  device->start = RegFileStart;
+  device->write = RegFileWrite;
+  device->read = RegFileRead;
+  device->stop = 0;
+  device->nack_start = 0;
+  device->nack_write = 0;
+  device->stretch_polls = 0;
+  device->starts = 0;
+  device->writes = 0;
+
+  regfile->memory = memory;
+  regfile->size = size;
+  regfile->address_bytes = address_bytes;
+  regfile->address_left = 0;
+  regfile->pointer = 0;
+  regfile->pointer_next = 0;
+}
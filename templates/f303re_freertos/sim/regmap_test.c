@@ -0,0 +1,197 @@
+/**
+ * @file regmap_test.c
+ * @author DFlubacher
+ * @brief Register map (bsp/regmap.c) driven by simulated host transactions,
+ * interleaved with application frames.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * The host side calls follow the I2C1 target interrupt: address match
+ * (`BspRegMapHostStart()`), received bytes, the preloaded byte and one
+ * further preload per transmitted byte, STOP.
+ * Exit status is the number of failed scenarios.
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "regmap.h"
+
+static BspRegMap map;
+
+// Bytes written by the host, as seen by the write callback.
+static uint8_t written_reg[8];
+static uint8_t written_value[8];
+static uint8_t written;
+
+static void OnWrite(uint8_t reg, uint8_t value, void* context) {
+  (void)context;
+  if (written < sizeof(written_reg)) {
+    written_reg[written] = reg;
+    written_value[written] = value;
+    ++written;
+  }
+}
+
+// ===   Host and application side   ==========================================
+
+/**
+ * @brief Write transaction up to the register pointer, no STOP (a repeated
+ * START may follow).
+ */
+static void HostPointer(uint8_t reg) {
+  BspRegMapHostStart(&map, 0);
+  BspRegMapHostWrite(&map, reg);
+}
+
+/**
+ * @brief Address match of a read transaction.
+ */
+static void HostReadStart(void) { BspRegMapHostStart(&map, 1); }
+
+/**
+ * @brief `count` bytes taken from the transmit register, each followed by
+ * the next preload.
+ */
+static void HostReadBytes(uint8_t* data, uint16_t count, uint8_t* preload) {
+  uint16_t i;
+
+  for (i = 0; i < count; ++i) {
+    data[i] = *preload;
+    *preload = BspRegMapHostReadNext(&map);
+  }
+}
+
+/**
+ * @brief Application frame: every register `base + reg`.
+ */
+static void AppFrame(uint8_t base) {
+  uint8_t* back = BspRegMapBegin(&map);
+  uint16_t reg;
+
+  for (reg = 0; reg < BSP_REGMAP_SIZE; ++reg) back[reg] = base + reg;
+  BspRegMapCommit(&map);
+}
+
+static uint8_t CheckFrame(const uint8_t* data, uint16_t count, uint8_t base,
+                          uint8_t reg) {
+  uint16_t i;
+
+  for (i = 0; i < count; ++i) {
+    if (data[i] != (uint8_t)(base + reg)) return 1;
+    reg = (reg + 1 < BSP_REGMAP_SIZE) ? reg + 1 : 0;
+  }
+  return 0;
+}
+
+// ===   Scenarios, return 0 on success   =====================================
+
+/**
+ * @brief Frames committed during a read are not served before its STOP,
+ * the whole read comes from one frame.
+ */
+static uint8_t ConsistentFrame(void) {
+  uint8_t data[32];
+  uint8_t preload;
+
+  AppFrame(0x10);
+  HostPointer(0);
+  HostReadStart();
+  preload = BspRegMapHostReadFirst(&map);
+  HostReadBytes(data, 8, &preload);
+  AppFrame(0x40);
+  HostReadBytes(&data[8], 8, &preload);
+  // Withdrawn and replaced while the read goes on.
+  AppFrame(0x70);
+  AppFrame(0xA0);
+  HostReadBytes(&data[16], 16, &preload);
+  BspRegMapHostStop(&map);
+  if (CheckFrame(data, 32, 0x10, 0) != 0) return 1;
+
+  // The last commit is served after the STOP, without a pointer write.
+  HostReadStart();
+  preload = BspRegMapHostReadFirst(&map);
+  HostReadBytes(data, 4, &preload);
+  BspRegMapHostStop(&map);
+  return CheckFrame(data, 4, 0xA0, 32);
+}
+
+/**
+ * @brief Register pointer write, repeated START, read from that register.
+ * The pointer write takes a frame committed before it.
+ */
+static uint8_t RepeatedStart(void) {
+  uint8_t data[6];
+  uint8_t preload;
+
+  AppFrame(0x00);
+  BspRegMapHostStop(&map);
+  AppFrame(0x80);
+  HostPointer(5);
+  HostReadStart();
+  preload = BspRegMapHostReadFirst(&map);
+  HostReadBytes(data, 6, &preload);
+  BspRegMapHostStop(&map);
+  return CheckFrame(data, 6, 0x80, 5);
+}
+
+/**
+ * @brief The pointer wraps from the last register to 0, for reads and
+ * writes; an out of range pointer starts at 0.
+ */
+static uint8_t PointerWrap(void) {
+  uint8_t data[4];
+  uint8_t preload;
+
+  AppFrame(0x20);
+  HostPointer(BSP_REGMAP_SIZE - 2);
+  HostReadStart();
+  preload = BspRegMapHostReadFirst(&map);
+  HostReadBytes(data, 4, &preload);
+  BspRegMapHostStop(&map);
+  if (CheckFrame(data, 4, 0x20, BSP_REGMAP_SIZE - 2) != 0) return 1;
+
+  written = 0;
+  HostPointer(BSP_REGMAP_SIZE - 1);
+  BspRegMapHostWrite(&map, 0x5A);
+  BspRegMapHostWrite(&map, 0xA5);
+  BspRegMapHostStop(&map);
+  if ((written != 2) || (written_reg[0] != BSP_REGMAP_SIZE - 1) ||
+      (written_value[0] != 0x5A) || (written_reg[1] != 0) ||
+      (written_value[1] != 0xA5)) {
+    return 1;
+  }
+
+  HostPointer(0xFF);
+  HostReadStart();
+  preload = BspRegMapHostReadFirst(&map);
+  HostReadBytes(data, 2, &preload);
+  BspRegMapHostStop(&map);
+  return CheckFrame(data, 2, 0x20, 0);
+}
+
+typedef struct {
+  const char* name;
+  uint8_t (*run)(void);
+} TestCase;
+
+static const TestCase cases[] = {
+    {"consistent frame across commit", ConsistentFrame},
+    {"pointer write, repeated start", RepeatedStart},
+    {"pointer wrap", PointerWrap},
+};
+
+int main(void) {
+  uint32_t failures = 0;
+  uint8_t result;
+  uint8_t i;
+
+  for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    BspRegMapInit(&map, OnWrite, 0);
+    result = cases[i].run();
+    printf("%-32s %s\n", cases[i].name, (result == 0) ? "ok" : "FAIL");
+    failures += result;
+  }
+  return (int)failures;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file sim.c
+ * @author DFlubacher
+ * @brief Trap-and-single-step engine for simulated register blocks.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "sim.h"
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+// x86 trap flag (EFLAGS.TF), single-step.
+#define SIM_EFLAGS_TF 0x100
+// Page fault error code: write access.
+#define SIM_PF_WRITE 0x02
+
+#define SIM_MAX_PERIPHERALS 8
+
+typedef struct {
+  uintptr_t page;
+  uintptr_t base;
+  SimAccessHook pre;
+  SimAccessHook post;
+  void* context;
+} SimPeripheral;
+
+// Core clock after SystemClockConfig(), normally in system_stm32f3xx.c.
+uint32_t SystemCoreClock = 48000000;
+
+static SimPeripheral peripherals[SIM_MAX_PERIPHERALS];
+static uint32_t nperipherals;
+static long page_size;
+static uint8_t initialized;
+
+// Access in flight between the fault and the single-step trap.
+static SimPeripheral* active;
+static uint32_t active_offset;
+static uint8_t active_write;
+static uint64_t access_count;
+
+static void SimFatal(const char* message) {
+  fprintf(stderr, "sim: %s\n", message);
+  abort();
+}
+
+static void SimSegvHandler(int sig, siginfo_t* info, void* context) {
+  ucontext_t* uc = (ucontext_t*)context;
+  uintptr_t address = (uintptr_t)info->si_addr;
+  uint32_t i;
+
+  for (i = 0; i < nperipherals; ++i) {
+    if ((address & ~(uintptr_t)(page_size - 1)) == peripherals[i].page) break;
+  }
+
+  // A genuine segmentation fault, let it crash.
+  if ((i == nperipherals) || (active != NULL)) {
+    signal(sig, SIG_DFL);
+    return;
+  }
+
+  active = &peripherals[i];
+  active_offset = (uint32_t)(address - active->base);
+  active_write = (uc->uc_mcontext.gregs[REG_ERR] & SIM_PF_WRITE) != 0;
+  ++access_count;
+
+  // Grant access, let the model prepare and execute the faulting instruction
+  // only.
+  mprotect((void*)active->page, page_size, PROT_READ | PROT_WRITE);
+  if (active->pre != NULL) {
+    active->pre(active_offset, active_write, active->context);
+  }
+  uc->uc_mcontext.gregs[REG_EFL] |= SIM_EFLAGS_TF;
+}
+
+static void SimTrapHandler(int sig, siginfo_t* info, void* context) {
+  ucontext_t* uc = (ucontext_t*)context;
+  SimPeripheral* peripheral = active;
+
+  (void)info;
+  uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_EFLAGS_TF;
+
+  // Not ours (debugger breakpoint...).
+  if (peripheral == NULL) {
+    signal(sig, SIG_DFL);
+    return;
+  }
+
+  if (peripheral->post != NULL) {
+    peripheral->post(active_offset, active_write, peripheral->context);
+  }
+  mprotect((void*)peripheral->page, page_size, PROT_NONE);
+  active = NULL;
+}
+
+void SimInit(void) {
+  struct sigaction action;
+
+  if (initialized) return;
+  initialized = 1;
+  page_size = sysconf(_SC_PAGESIZE);
+
+  memset(&action, 0, sizeof(action));
+  action.sa_flags = SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+
+  action.sa_sigaction = SimSegvHandler;
+  if (sigaction(SIGSEGV, &action, NULL) != 0) SimFatal("sigaction SIGSEGV");
+
+  action.sa_sigaction = SimTrapHandler;
+  if (sigaction(SIGTRAP, &action, NULL) != 0) SimFatal("sigaction SIGTRAP");
+}
+
+/**
+ * @brief Map the pages covering [base, base + size) at their fixed address.
+ * Pages already mapped by a previous call are kept.
+ */
+static void SimMapPages(uintptr_t base, uint32_t size) {
+  uintptr_t page;
+  uintptr_t end = base + size;
+  void* mapped;
+
+  for (page = base & ~(uintptr_t)(page_size - 1); page < end;
+       page += page_size) {
+    mapped = mmap((void*)page, page_size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mapped == MAP_FAILED) {
+      // Mapped before (EEXIST) is fine, anything else is not.
+      if (msync((void*)page, page_size, MS_ASYNC) != 0) {
+        SimFatal("cannot map peripheral address");
+      }
+    } else if (mapped != (void*)page) {
+      SimFatal("peripheral address not available");
+    }
+  }
+}
+
+void SimMapMemory(uintptr_t base, uint32_t size) {
+  SimInit();
+  SimMapPages(base, size);
+}
+
+volatile void* SimMapPeripheral(uintptr_t base, SimAccessHook pre,
+                                SimAccessHook post, void* context) {
+  SimPeripheral* peripheral;
+
+  SimInit();
+  if (nperipherals == SIM_MAX_PERIPHERALS) SimFatal("too many peripherals");
+
+  SimMapPages(base, 1);
+  peripheral = &peripherals[nperipherals++];
+  peripheral->page = base & ~(uintptr_t)(page_size - 1);
+  peripheral->base = base;
+  peripheral->pre = pre;
+  peripheral->post = post;
+  peripheral->context = context;
+
+  return (volatile void*)base;
+}
+
+void SimArm(void) {
+  uint32_t i;
+
+  for (i = 0; i < nperipherals; ++i) {
+    mprotect((void*)peripherals[i].page, page_size, PROT_NONE);
+  }
+}
+
+uint64_t SimAccessCount(void) { return access_count; }
@@ -0,0 +1,270 @@
+/**
+ * @file sim_i2c.c
+ * @author DFlubacher
+ * @brief Simulated I2C1 controller.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "sim_i2c.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sim.h"
+#include "stm32f3xx.h"
+
+#define SIM_I2C_REG(name) offsetof(I2C_TypeDef, name)
+
+typedef struct {
+  volatile I2C_TypeDef* regs;
+  SimI2cDevice* devices[SIM_I2C_MAX_DEVICES];
+  uint32_t ndevices;
+
+  // Addressed device, NULL when idle.
+  SimI2cDevice* device;
+  uint8_t read;
+  // Bytes left in the current NBYTES chunk.
+  uint32_t left;
+  // Flags becoming visible after `delay` status polls (clock stretching).
+  uint32_t pending;
+  uint32_t delay;
+  // ISR before the access, restores read-only bits on a write.
+  uint32_t isr_shadow;
+
+  SimI2cStats stats;
+} SimI2c;
+
+static SimI2c i2c;
+
+static uint64_t SimI2cSclPeriodNs(void) {
+  uint32_t timingr = i2c.regs->TIMINGR;
+  uint64_t presc = ((timingr & I2C_TIMINGR_PRESC_Msk) >> I2C_TIMINGR_PRESC_Pos);
+  uint64_t scll = ((timingr & I2C_TIMINGR_SCLL_Msk) >> I2C_TIMINGR_SCLL_Pos);
+  uint64_t sclh = ((timingr & I2C_TIMINGR_SCLH_Msk) >> I2C_TIMINGR_SCLH_Pos);
+
+  return (presc + 1) * (scll + 1 + sclh + 1) * 1000000000ULL /
+         SIM_I2C_CLOCK_HZ;
+}
+
+static void SimI2cRaise(uint32_t flags) {
+  if ((i2c.device != NULL) && (i2c.device->stretch_polls > 0)) {
+    i2c.pending |= flags;
+    i2c.delay = i2c.device->stretch_polls;
+  } else {
+    i2c.regs->ISR |= flags;
+  }
+}
+
+static void SimI2cStop(void) {
+  if ((i2c.device != NULL) && (i2c.device->stop != NULL)) {
+    i2c.device->stop(i2c.device);
+  }
+  i2c.device = NULL;
+  i2c.pending = 0;
+  i2c.left = 0;
+  i2c.regs->CR2 &= ~I2C_CR2_STOP;
+  i2c.regs->ISR &= ~(I2C_ISR_BUSY | I2C_ISR_TXIS | I2C_ISR_RXNE |
+                     I2C_ISR_TC | I2C_ISR_TCR);
+  i2c.regs->ISR |= (I2C_ISR_STOPF | I2C_ISR_TXE);
+  ++i2c.stats.stops;
+  i2c.stats.bus_time_ns += SimI2cSclPeriodNs();
+}
+
+static void SimI2cNack(void) {
+  i2c.regs->ISR |= I2C_ISR_NACKF;
+  ++i2c.stats.nacks;
+  // The hardware sends STOP automatically after a NACK.
+  SimI2cStop();
+}
+
+static void SimI2cNextByte(void) {
+  if (i2c.read) {
+    i2c.regs->RXDR =
+        (i2c.device->read != NULL) ? i2c.device->read(i2c.device) : 0xFF;
+    ++i2c.stats.bytes;
+    i2c.stats.bus_time_ns += 9 * SimI2cSclPeriodNs();
+    SimI2cRaise(I2C_ISR_RXNE);
+  } else {
+    SimI2cRaise(I2C_ISR_TXIS);
+  }
+}
+
+static void SimI2cAfterByte(void) {
+  uint32_t cr2 = i2c.regs->CR2;
+
+  if (i2c.left > 0) {
+    SimI2cNextByte();
+  } else if ((cr2 & I2C_CR2_RELOAD) == I2C_CR2_RELOAD) {
+    SimI2cRaise(I2C_ISR_TCR);
+  } else if ((cr2 & I2C_CR2_AUTOEND) == I2C_CR2_AUTOEND) {
+    SimI2cStop();
+  } else {
+    SimI2cRaise(I2C_ISR_TC);
+  }
+}
+
+static void SimI2cStart(uint32_t cr2) {
+  uint8_t address = ((cr2 & I2C_CR2_SADD_Msk) >> (I2C_CR2_SADD_Pos + 1));
+  uint32_t i;
+  uint8_t nack;
+
+  // START is cleared by hardware once the address is sent.
+  i2c.regs->CR2 &= ~I2C_CR2_START;
+  i2c.regs->ISR &= ~(I2C_ISR_TC | I2C_ISR_TCR);
+  i2c.regs->ISR |= I2C_ISR_BUSY;
+  i2c.read = (cr2 & I2C_CR2_RD_WRN) == I2C_CR2_RD_WRN;
+  i2c.left = (cr2 & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+  i2c.pending = 0;
+  ++i2c.stats.starts;
+  i2c.stats.bus_time_ns += 10 * SimI2cSclPeriodNs();
+
+  // Previous device on a repeated START to another address.
+  if ((i2c.device != NULL) && (i2c.device->address != address)) {
+    if (i2c.device->stop != NULL) i2c.device->stop(i2c.device);
+  }
+  i2c.device = NULL;
+  for (i = 0; i < i2c.ndevices; ++i) {
+    if (i2c.devices[i]->address == address) i2c.device = i2c.devices[i];
+  }
+  if (i2c.device == NULL) {
+    SimI2cNack();
+    return;
+  }
+
+  ++i2c.device->starts;
+  nack = (i2c.device->nack_start == i2c.device->starts);
+  if (!nack && (i2c.device->start != NULL)) {
+    nack = i2c.device->start(i2c.device, i2c.read);
+  }
+  if (nack) {
+    SimI2cNack();
+    return;
+  }
+
+  SimI2cAfterByte();
+}
+
+static void SimI2cTransmit(void) {
+  uint8_t value = (uint8_t)i2c.regs->TXDR;
+  uint8_t nack;
+
+  i2c.regs->ISR &= ~I2C_ISR_TXIS;
+  if ((i2c.device == NULL) || i2c.read) return;
+
+  ++i2c.device->writes;
+  ++i2c.stats.bytes;
+  i2c.stats.bus_time_ns += 9 * SimI2cSclPeriodNs();
+  nack = (i2c.device->nack_write == i2c.device->writes);
+  if (!nack && (i2c.device->write != NULL)) {
+    nack = i2c.device->write(i2c.device, value);
+  }
+  if (nack) {
+    SimI2cNack();
+    return;
+  }
+
+  --i2c.left;
+  SimI2cAfterByte();
+}
+
+static void SimI2cReset(void) {
+  i2c.device = NULL;
+  i2c.pending = 0;
+  i2c.left = 0;
+  i2c.regs->ISR = I2C_ISR_TXE;
+}
+
+static void SimI2cPre(uint32_t offset, uint8_t is_write, void* context) {
+  (void)context;
+  ++i2c.stats.accesses;
+
+  if (offset != SIM_I2C_REG(ISR)) return;
+  i2c.isr_shadow = i2c.regs->ISR;
+  if (is_write) return;
+
+  // Status poll: time passes, a stretched byte eventually completes.
+  ++i2c.stats.status_polls;
+  if (i2c.pending != 0) {
+    if (i2c.delay == 0) {
+      i2c.regs->ISR |= i2c.pending;
+      i2c.pending = 0;
+    } else {
+      --i2c.delay;
+    }
+  }
+}
+
+static void SimI2cPost(uint32_t offset, uint8_t is_write, void* context) {
+  uint32_t value;
+
+  (void)context;
+
+  if (!is_write) {
+    // Reading RXDR clears RXNE.
+    if ((offset == SIM_I2C_REG(RXDR)) &&
+        ((i2c.regs->ISR & I2C_ISR_RXNE) == I2C_ISR_RXNE)) {
+      i2c.regs->ISR &= ~I2C_ISR_RXNE;
+      --i2c.left;
+      SimI2cAfterByte();
+    }
+    return;
+  }
+
+  if (offset == SIM_I2C_REG(CR1)) {
+    // Clearing PE is a software reset.
+    if ((i2c.regs->CR1 & I2C_CR1_PE) == 0) SimI2cReset();
+  } else if (offset == SIM_I2C_REG(CR2)) {
+    value = i2c.regs->CR2;
+    if ((value & I2C_CR2_START) == I2C_CR2_START) {
+      SimI2cStart(value);
+    } else if ((value & I2C_CR2_STOP) == I2C_CR2_STOP) {
+      SimI2cStop();
+    } else if ((i2c.regs->ISR & I2C_ISR_TCR) == I2C_ISR_TCR) {
+      // NBYTES reloaded.
+      i2c.regs->ISR &= ~I2C_ISR_TCR;
+      i2c.left = (value & I2C_CR2_NBYTES_Msk) >> I2C_CR2_NBYTES_Pos;
+      SimI2cAfterByte();
+    }
+  } else if (offset == SIM_I2C_REG(TXDR)) {
+    SimI2cTransmit();
+  } else if (offset == SIM_I2C_REG(ICR)) {
+    value = i2c.regs->ICR;
+    i2c.regs->ICR = 0;
+    if (value & I2C_ICR_ADDRCF) i2c.regs->ISR &= ~I2C_ISR_ADDR;
+    if (value & I2C_ICR_NACKCF) i2c.regs->ISR &= ~I2C_ISR_NACKF;
+    if (value & I2C_ICR_STOPCF) i2c.regs->ISR &= ~I2C_ISR_STOPF;
+    if (value & I2C_ICR_BERRCF) i2c.regs->ISR &= ~I2C_ISR_BERR;
+    if (value & I2C_ICR_ARLOCF) i2c.regs->ISR &= ~I2C_ISR_ARLO;
+    if (value & I2C_ICR_OVRCF) i2c.regs->ISR &= ~I2C_ISR_OVR;
+  } else if (offset == SIM_I2C_REG(ISR)) {
+    // Only TXE (flush) is writable in master mode.
+    value = i2c.regs->ISR;
+    i2c.regs->ISR = i2c.isr_shadow | (value & I2C_ISR_TXE);
+  }
+}
+
+void SimI2cInit(void) {
+  memset(&i2c, 0, sizeof(i2c));
+
+  // Blocks written by the BSP during initialization, no behavior.
+  SimMapMemory(RCC_BASE, sizeof(RCC_TypeDef));
+  SimMapMemory(GPIOA_BASE, GPIOF_BASE + sizeof(GPIO_TypeDef) - GPIOA_BASE);
+  SimMapMemory(SCS_BASE, 0x1000);
+
+  i2c.regs = (volatile I2C_TypeDef*)SimMapPeripheral(I2C1_BASE, SimI2cPre,
+                                                      SimI2cPost, NULL);
+  SimI2cReset();
+}
+
+void SimI2cAttach(SimI2cDevice* device) {
+  if (i2c.ndevices < SIM_I2C_MAX_DEVICES) {
+    i2c.devices[i2c.ndevices++] = device;
+  }
+}
+
+void SimI2cGetStats(SimI2cStats* stats) { *stats = i2c.stats; }
+
+void SimI2cResetStats(void) { memset(&i2c.stats, 0, sizeof(i2c.stats)); }
@@ -0,0 +1,279 @@
+/**
+ * @file ubx_replay.c
+ * @author DFlubacher
+ * @brief Feed UBX byte streams through the parser (bsp/ubx.c) the way the SPI
+ * DMA would: in chunks of varying size into a ring buffer.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Usage:
+ * - ubx_replay <file>: replay a recorded stream, print NAV-PVT and counters.
+ * - ubx_replay: generate a stream with known content (filler, corrupted and
+ *   unknown frames) and check what comes out for several chunk patterns.
+ * Exit status is the number of failed checks.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ubx.h"
+
+#define RING_SIZE 1024
+#define STREAM_SIZE (256 * 1024)
+#define FRAMES 500
+
+static uint8_t ring[RING_SIZE];
+static uint8_t stream[STREAM_SIZE];
+static uint32_t stream_length;
+
+// NAV-PVT time of week of the expected (intact) frames, in order.
+static uint32_t expected_itow[FRAMES];
+static uint32_t nexpected;
+
+typedef struct {
+  uint8_t verbose;
+  uint32_t pvt;
+  uint32_t acks;
+  uint32_t mismatches;
+} Results;
+
+static uint64_t NowNs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// ===   Handlers   ============================================================
+
+static void OnNavPvt(const BspUbxMessage* message, void* context) {
+  Results* results = (Results*)context;
+  BspUbxNavPvt pvt;
+
+  if (BspUbxNavPvtDecode(message, &pvt) != 0) {
+    ++results->mismatches;
+    return;
+  }
+
+  if (results->verbose) {
+    printf("NAV-PVT itow %10u fix %u sv %2u lat %11.7f lon %11.7f h %8.3f m\n",
+           pvt.itow, pvt.fix_type, pvt.num_sv, pvt.lat * 1e-7, pvt.lon * 1e-7,
+           pvt.h_msl * 1e-3);
+  } else {
+    uint32_t k = pvt.itow / 1000;
+    // The generator derives every field from the frame number.
+    if ((results->pvt >= nexpected) ||
+        (pvt.itow != expected_itow[results->pvt]) ||
+        (pvt.lat != (int32_t)(473977418 + k)) ||
+        (pvt.lon != (int32_t)(85455938 - k)) ||
+        (pvt.num_sv != (uint8_t)(k % 30)) || (pvt.year != 2026) ||
+        (pvt.vel_d != -(int32_t)k)) {
+      ++results->mismatches;
+    }
+  }
+  ++results->pvt;
+}
+
+static void OnAck(const BspUbxMessage* message, void* context) {
+  Results* results = (Results*)context;
+  ++results->acks;
+}
+
+// ===   Stream generator   ====================================================
+
+static void Put(uint8_t value) {
+  if (stream_length < STREAM_SIZE) stream[stream_length++] = value;
+}
+
+static void PutFrame(uint8_t msg_class, uint8_t msg_id, const uint8_t* payload,
+                     uint16_t length, uint8_t corrupt) {
+  uint8_t ck_a = 0;
+  uint8_t ck_b = 0;
+  uint8_t header[4] = {msg_class, msg_id, (uint8_t)length,
+                       (uint8_t)(length >> 8)};
+  uint32_t i;
+
+  Put(0xB5);
+  Put(0x62);
+  for (i = 0; i < 4; ++i) {
+    ck_a += header[i];
+    ck_b += ck_a;
+    Put(header[i]);
+  }
+  for (i = 0; i < length; ++i) {
+    ck_a += payload[i];
+    ck_b += ck_a;
+    Put(payload[i]);
+  }
+  Put(ck_a);
+  Put((uint8_t)(ck_b ^ corrupt));
+}
+
+static void Set32(uint8_t* payload, uint16_t offset, uint32_t value) {
+  payload[offset] = (uint8_t)value;
+  payload[offset + 1] = (uint8_t)(value >> 8);
+  payload[offset + 2] = (uint8_t)(value >> 16);
+  payload[offset + 3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Known stream: NAV-PVT frames separated by 0xFF filler, with ACKs,
+ * unknown messages, corrupted checksums and spurious sync characters.
+ *
+ * @param acks number of ACK-ACK frames generated.
+ */
+static void Generate(uint32_t* acks) {
+  uint8_t payload[BSP_UBX_NAV_PVT_LENGTH];
+  uint8_t ack[2] = {0x06, 0x8A};
+  uint8_t unknown[30];
+  uint32_t k;
+  uint32_t i;
+
+  stream_length = 0;
+  nexpected = 0;
+  *acks = 0;
+  srand(1);
+  memset(unknown, 0xB5, sizeof(unknown));
+
+  for (k = 0; k < FRAMES; ++k) {
+    uint32_t filler = (uint32_t)rand() % 48;
+    uint8_t corrupt = ((k % 10) == 9) ? 0x01 : 0x00;
+
+    for (i = 0; i < filler; ++i) Put(0xFF);
+    if ((k % 50) == 0) {
+      Put(0xB5);
+      Put(0xB5);
+    }
+
+    memset(payload, 0, sizeof(payload));
+    Set32(payload, 0, k * 1000);
+    payload[4] = (uint8_t)(2026 & 0xFF);
+    payload[5] = (uint8_t)(2026 >> 8);
+    payload[20] = 3;
+    payload[23] = (uint8_t)(k % 30);
+    Set32(payload, 24, (uint32_t)(85455938 - k));
+    Set32(payload, 28, (uint32_t)(473977418 + k));
+    Set32(payload, 56, (uint32_t)(-(int32_t)k));
+    PutFrame(BSP_UBX_CLASS_NAV, BSP_UBX_ID_NAV_PVT, payload, sizeof(payload),
+             corrupt);
+    if (!corrupt) expected_itow[nexpected++] = k * 1000;
+
+    if ((k % 7) == 0) {
+      PutFrame(BSP_UBX_CLASS_ACK, BSP_UBX_ID_ACK_ACK, ack, sizeof(ack), 0);
+      ++*acks;
+    }
+    if ((k % 11) == 0) {
+      // Payload full of sync characters, must not confuse the parser.
+      PutFrame(0x0A, 0x04, unknown, sizeof(unknown), 0);
+    }
+  }
+}
+
+// ===   Replay   ==============================================================
+
+/**
+ * @brief Copy the stream into the ring in chunks of 1 ... `max_chunk` bytes,
+ * never overwriting the frame in progress, and parse after each chunk.
+ *
+ * @param parser
+ * @param max_chunk
+ */
+static void Replay(BspUbxParser* parser, uint32_t max_chunk) {
+  uint32_t position = 0;
+  uint16_t write = 0;
+
+  while (position < stream_length) {
+    uint32_t tail = BspUbxTail(parser);
+    uint32_t space = (tail + RING_SIZE - write - 1) % RING_SIZE;
+    uint32_t chunk = 1 + (uint32_t)rand() % max_chunk;
+    uint32_t i;
+
+    if (chunk > space) chunk = space;
+    if (chunk > (stream_length - position)) chunk = stream_length - position;
+
+    for (i = 0; i < chunk; ++i) {
+      ring[write] = stream[position++];
+      write = (uint16_t)((write + 1) % RING_SIZE);
+    }
+    BspUbxParse(parser, write);
+  }
+}
+
+static uint8_t ReadFile(const char* path) {
+  FILE* file = fopen(path, "rb");
+
+  if (file == NULL) {
+    perror(path);
+    return 1;
+  }
+  stream_length = (uint32_t)fread(stream, 1, STREAM_SIZE, file);
+  fclose(file);
+  if (stream_length == STREAM_SIZE) {
+    fprintf(stderr, "%s: truncated to %u bytes\n", path, STREAM_SIZE);
+  }
+  return 0;
+}
+
+static void PrintStats(const char* name, const BspUbxStats* stats,
+                       double ns_per_byte) {
+  printf("%-12s frames %6u unhandled %5u checksum %4u length %3u skipped %7u"
+         " %6.2f ns/byte\n",
+         name, stats->frames, stats->unhandled, stats->checksum_errors,
+         stats->length_errors, stats->skipped, ns_per_byte);
+}
+
+int main(int argc, char** argv) {
+  static const uint32_t chunks[] = {1, 7, 64, 256, 900};
+  BspUbxParser parser;
+  Results results;
+  BspUbxRoute routes[2] = {
+      {BSP_UBX_CLASS_NAV, BSP_UBX_ID_NAV_PVT, OnNavPvt, &results},
+      {BSP_UBX_CLASS_ACK, BSP_UBX_ID_ACK_ACK, OnAck, &results},
+  };
+  uint32_t failures = 0;
+  uint32_t acks;
+  uint32_t i;
+
+  if (argc > 1) {
+    if (ReadFile(argv[1]) != 0) return 1;
+    memset(&results, 0, sizeof(results));
+    results.verbose = 1;
+    BspUbxInit(&parser, ring, RING_SIZE, routes, 2);
+    Replay(&parser, 256);
+    PrintStats(argv[1], &parser.stats, 0.0);
+    return 0;
+  }
+
+  Generate(&acks);
+  for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); ++i) {
+    char name[16];
+    uint64_t start;
+    double ns_per_byte;
+    uint8_t failed;
+
+    memset(&results, 0, sizeof(results));
+    BspUbxInit(&parser, ring, RING_SIZE, routes, 2);
+    srand(i + 1);
+    start = NowNs();
+    Replay(&parser, chunks[i]);
+    ns_per_byte = (double)(NowNs() - start) / stream_length;
+
+    failed = (results.pvt != nexpected) || (results.acks != acks) ||
+             (results.mismatches != 0) ||
+             (parser.stats.checksum_errors != (FRAMES / 10));
+    failures += failed;
+
+    snprintf(name, sizeof(name), "chunk %u", chunks[i]);
+    PrintStats(name, &parser.stats, ns_per_byte);
+    printf("%-12s pvt %u/%u ack %u/%u mismatches %u: %s\n", "", results.pvt,
+           nexpected, results.acks, acks, results.mismatches,
+           failed ? "FAIL" : "ok");
+  }
+
+  return (int)failures;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file wheel_bench.c
+ * @author DFlubacher
+ * @brief Timer wheel (bsp/timer_wheel.c) against the FreeRTOS timer list.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * 1. Correctness: random arm/cancel/advance, including timeouts beyond the
+ *    wheel range; every timer must fire exactly at its expiry, cancelled
+ *    ones never.
+ * 2. Cost at 10, 100 and 1000 active timers: cancel and re-arm a random
+ *    timer (a request answered before its timeout), and the cost per tick.
+ *    The FreeRTOS side runs the real list.c operations the timer task
+ *    executes for xTimerStart()/xTimerStop(): vListInsert() into the sorted
+ *    active list and uxListRemove(). On the target both calls also pay a
+ *    queue send and a switch to the timer task, the same for any number of
+ *    timers.
+ * Exit status is the number of failed checks.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "list.h"
+#include "timer_wheel.h"
+
+#define MAX_TIMERS 1000
+#define OPERATIONS 1000000
+#define TICKS 200000
+
+// Per-request timeouts, ticks.
+#define TIMEOUT_MIN 10
+#define TIMEOUT_SPAN 5000
+
+static BspTimerWheel wheel;
+static BspWheelTimer timers[MAX_TIMERS];
+static ListItem_t items[MAX_TIMERS];
+static List_t active_list;
+
+// Correctness check state.
+static uint32_t expected[MAX_TIMERS];
+static uint8_t armed[MAX_TIMERS];
+static uint32_t errors;
+static uint32_t fired;
+
+static uint64_t NowNs(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static uint32_t Timeout(void) {
+  return TIMEOUT_MIN + (uint32_t)rand() % TIMEOUT_SPAN;
+}
+
+// ===   Correctness   =========================================================
+
+static void OnCheck(BspWheelTimer* timer, void* context) {
+  uint32_t i = (uint32_t)(timer - timers);
+
+  if (!armed[i] || (wheel.now != expected[i])) ++errors;
+  armed[i] = 0;
+  ++fired;
+}
+
+static void Arm(uint32_t i, uint32_t ticks) {
+  BspWheelTimerArm(&wheel, &timers[i], ticks);
+  expected[i] = wheel.now + ticks;
+  armed[i] = 1;
+}
+
+static uint8_t CheckWheel(void) {
+  uint32_t n;
+  uint32_t i;
+  uint32_t armed_count = 0;
+
+  srand(1);
+  BspTimerWheelInit(&wheel, 0xFFFFF000U);
+  for (i = 0; i < MAX_TIMERS; ++i) BspWheelTimerInit(&timers[i], OnCheck, 0);
+  memset(armed, 0, sizeof(armed));
+  errors = 0;
+  fired = 0;
+
+  for (n = 0; n < 200000; ++n) {
+    i = (uint32_t)rand() % MAX_TIMERS;
+    switch (rand() % 4) {
+      case 0:
+      case 1:
+        // Up to 4 levels, a few beyond the wheel range.
+        if ((rand() % 1000) == 0) {
+          Arm(i, BSP_WHEEL_RANGE + (uint32_t)rand() % 100000);
+        } else {
+          Arm(i, 1 + ((uint32_t)rand() >> (rand() % 31)) % 300000);
+        }
+        ++armed_count;
+        break;
+      case 2:
+        BspWheelTimerCancel(&wheel, &timers[i]);
+        armed[i] = 0;
+        break;
+      default:
+        BspTimerWheelAdvance(&wheel, wheel.now + (uint32_t)rand() % 50);
+        break;
+    }
+  }
+
+  // Run everything out (the counter wraps on the way).
+  BspTimerWheelAdvance(&wheel, wheel.now + BSP_WHEEL_RANGE);
+  BspTimerWheelAdvance(&wheel, wheel.now + 200000);
+  for (i = 0; i < MAX_TIMERS; ++i) {
+    if (armed[i] || BspWheelTimerActive(&timers[i])) ++errors;
+  }
+
+  printf("check: armed %u fired %u cancelled %u cascaded %u errors %u: %s\n",
+         wheel.stats.armed, fired, wheel.stats.cancelled,
+         wheel.stats.cascaded, errors, errors ? "FAIL" : "ok");
+  return errors != 0;
+}
+
+// ===   Cost   ================================================================
+
+static void OnBench(BspWheelTimer* timer, void* context) {
+  BspWheelTimerArm(&wheel, timer, Timeout());
+}
+
+/**
+ * @brief FreeRTOS timer task, xTimerStart(): set the expiry, insert sorted.
+ */
+static void ListArm(uint32_t i, TickType_t now) {
+  listSET_LIST_ITEM_VALUE(&items[i], now + Timeout());
+  vListInsert(&active_list, &items[i]);
+}
+
+static void Bench(uint32_t count) {
+  uint64_t start;
+  double wheel_ns;
+  double list_ns;
+  double tick_ns;
+  uint32_t n;
+  uint32_t i;
+
+  // Wheel: cancel and re-arm random timers.
+  srand(count);
+  BspTimerWheelInit(&wheel, 0);
+  for (i = 0; i < count; ++i) {
+    BspWheelTimerInit(&timers[i], OnBench, 0);
+    BspWheelTimerArm(&wheel, &timers[i], Timeout());
+  }
+  start = NowNs();
+  for (n = 0; n < OPERATIONS; ++n) {
+    i = (uint32_t)rand() % count;
+    BspWheelTimerCancel(&wheel, &timers[i]);
+    BspWheelTimerArm(&wheel, &timers[i], Timeout());
+  }
+  wheel_ns = (double)(NowNs() - start) / OPERATIONS;
+
+  // Wheel: ticks, expired timers re-arm themselves.
+  start = NowNs();
+  BspTimerWheelAdvance(&wheel, wheel.now + TICKS);
+  tick_ns = (double)(NowNs() - start) / TICKS;
+
+  // FreeRTOS list: the same operations.
+  srand(count);
+  vListInitialise(&active_list);
+  for (i = 0; i < count; ++i) {
+    vListInitialiseItem(&items[i]);
+    ListArm(i, 0);
+  }
+  start = NowNs();
+  for (n = 0; n < OPERATIONS; ++n) {
+    i = (uint32_t)rand() % count;
+    (void)uxListRemove(&items[i]);
+    ListArm(i, 0);
+  }
+  list_ns = (double)(NowNs() - start) / OPERATIONS;
+
+  printf("%6u %18.1f %18.1f %10.1f %8.1f\n", count, wheel_ns, list_ns,
+         list_ns / wheel_ns, tick_ns);
+}
+
+int main(void) {
+  static const uint32_t counts[] = {10, 100, 1000};
+  uint32_t failures = 0;
+  uint32_t i;
+
+  failures += CheckWheel();
+
+  printf("\n%6s %18s %18s %10s %8s\n", "timers", "wheel ns/cancel+arm",
+         "list ns/cancel+arm", "ratio", "tick ns");
+  for (i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) Bench(counts[i]);
+
+  return (int)failures;
+}